@@ -0,0 +1,336 @@
+// batch_runner.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <errno.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#include "batch_runner.h"
+#include "column_file.h"
+#include "csv_loader.h"
+#include "data_processing.h"
+#include "dsp_context.h"
+#include "dsp_stats.h"
+#include "pipeline.h"
+#include "thread_pool.h"
+
+#define BATCH_AXIS_COUNT 6
+#define BATCH_FIRST_AXIS_COLUMN 5   // AX, AY, AZ, GX, GY, GZ 位於第 5 到 10 列
+#define BATCH_TIMESTAMP_COLUMN 0    // 時間戳（秒），載入在所有軸之後
+
+static const char* const kAxisNames[BATCH_AXIS_COUNT] = {"AX", "AY", "AZ", "GX", "GY", "GZ"};
+
+typedef struct BatchContext BatchContext;
+typedef struct FileJob FileJob;
+
+typedef struct {
+    FileJob* file;
+    int axis;
+} AxisJob;
+
+struct FileJob {
+    BatchContext* context;
+    const char* path;
+    CsvData csv;
+    double sampleRate;        // 由時間戳估計，無法估計時為 0
+    atomic_int axesRemaining;
+    atomic_int axisFailures;
+    AxisJob axes[BATCH_AXIS_COUNT];
+};
+
+// 每個工作執行緒專用、重複使用的暫存空間；最後一格給主執行緒在無法排入佇列時直接執行任務
+typedef struct {
+    DspContext context;     // 處理鏈緩衝區之後是每個軸的輸出
+    Pipeline pipeline;
+} WorkerScratch;
+
+struct BatchContext {
+    ThreadPool* pool;
+    WorkerScratch* scratch;
+    const BatchOptions* options;
+    atomic_llong samplesProcessed;
+    atomic_int filesFailed;
+};
+
+static double monotonicSeconds(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+// 輸出檔名：輸入檔名去掉 ".csv" 後加上 ".cdsp"，放在 outputDirectory 或輸入檔旁
+static int batchOutputPath(const char* inputPath, const char* outputDirectory, char* buffer, size_t bufferSize) {
+    const char* name = inputPath;
+    size_t directoryLength = 0;
+    const char* slash = strrchr(inputPath, '/');
+    if (slash != NULL) {
+        name = slash + 1;
+        directoryLength = (size_t)(slash - inputPath);
+    }
+    size_t nameLength = strlen(name);
+    if (nameLength > 4 && strcmp(name + nameLength - 4, ".csv") == 0) {
+        nameLength -= 4;
+    }
+    int length;
+    if (outputDirectory != NULL) {
+        length = snprintf(buffer, bufferSize, "%s/%.*s.cdsp", outputDirectory, (int)nameLength, name);
+    } else if (slash != NULL) {
+        length = snprintf(buffer, bufferSize, "%.*s/%.*s.cdsp", (int)directoryLength, inputPath, (int)nameLength, name);
+    } else {
+        length = snprintf(buffer, bufferSize, "%.*s.cdsp", (int)nameLength, name);
+    }
+    return length >= 0 && (size_t)length < bufferSize ? 0 : -1;
+}
+
+// 所有軸都已原地濾波：寫出結果並釋放整個檔案的資料
+static void finishFile(FileJob* file) {
+    BatchContext* context = file->context;
+    int failed = atomic_load(&file->axisFailures) > 0;
+    if (!failed) {
+        int rowCount = file->csv.columns[0].count;
+        ColumnSpec columns[BATCH_AXIS_COUNT];
+        for (int i = 0; i < BATCH_AXIS_COUNT; ++i) {
+            if (file->csv.columns[i].count < rowCount) {
+                rowCount = file->csv.columns[i].count;
+            }
+            columns[i].name = kAxisNames[i];
+            columns[i].dtype = COLUMN_DTYPE_FLOAT64;
+            columns[i].data = file->csv.columns[i].data;
+        }
+        char outputPath[4096];
+        if (batchOutputPath(file->path, context->options->outputDirectory, outputPath, sizeof(outputPath)) != 0
+            || writeColumnFile(outputPath, file->sampleRate, rowCount, columns, BATCH_AXIS_COUNT, NULL) != 0) {
+            fprintf(stderr, "%s: failed to write filtered output\n", file->path);
+            failed = 1;
+        }
+    }
+    if (failed) {
+        atomic_fetch_add(&context->filesFailed, 1);
+    }
+    freeCsvData(&file->csv);
+}
+
+static void axisTask(void* argument, int workerIndex) {
+    AxisJob* job = argument;
+    FileJob* file = job->file;
+    BatchContext* context = file->context;
+    WorkerScratch* scratch = &context->scratch[workerIndex];
+    CsvColumn* column = &file->csv.columns[job->axis];
+
+    // 原地濾波：結果留在 CSV 欄位中，由最後完成的軸寫出
+    if (pipelineRun(&scratch->pipeline, column->data, column->data, column->count) >= 0) {
+        atomic_fetch_add(&context->samplesProcessed, column->count);
+    } else {
+        fprintf(stderr, "%s: filtering failed on axis %s\n", file->path, kAxisNames[job->axis]);
+        atomic_fetch_add(&file->axisFailures, 1);
+    }
+
+    if (atomic_fetch_sub(&file->axesRemaining, 1) == 1) {
+        finishFile(file);
+    }
+}
+
+static void loadTask(void* argument, int workerIndex) {
+    FileJob* file = argument;
+    BatchContext* context = file->context;
+    WorkerScratch* scratch = &context->scratch[workerIndex];
+
+    int columns[BATCH_AXIS_COUNT + 1];
+    for (int i = 0; i < BATCH_AXIS_COUNT; ++i) {
+        columns[i] = BATCH_FIRST_AXIS_COLUMN + i;
+    }
+    columns[BATCH_AXIS_COUNT] = BATCH_TIMESTAMP_COLUMN;
+    if (loadCsvColumns(file->path, columns, BATCH_AXIS_COUNT + 1, context->options->maxRows, &file->csv) != 0) {
+        fprintf(stderr, "%s: failed to read CSV data\n", file->path);
+        atomic_fetch_add(&context->filesFailed, 1);
+        return;
+    }
+    for (int i = 0; i < BATCH_AXIS_COUNT; ++i) {
+        if (file->csv.columns[i].count == 0) {
+            fprintf(stderr, "%s: no %s values\n", file->path, kAxisNames[i]);
+            atomic_fetch_add(&context->filesFailed, 1);
+            freeCsvData(&file->csv);
+            return;
+        }
+    }
+
+    // 與 main 相同，以時間戳估計採樣率寫入輸出檔頭
+    const CsvColumn* timestamps = &file->csv.columns[BATCH_AXIS_COUNT];
+    DspContextMark mark = dspContextMark(&scratch->context);
+    double* deltas = timestamps->count > 1 ? dspContextAllocDoubles(&scratch->context, (size_t)timestamps->count - 1) : NULL;
+    file->sampleRate = estimateSampleRate(timestamps->data, timestamps->count, deltas);
+    dspContextRelease(&scratch->context, &mark);
+
+    // 每個軸是獨立的任務，閒置的執行緒會從這裡偷走
+    atomic_store(&file->axesRemaining, BATCH_AXIS_COUNT);
+    atomic_store(&file->axisFailures, 0);
+    for (int i = 0; i < BATCH_AXIS_COUNT; ++i) {
+        file->axes[i].file = file;
+        file->axes[i].axis = i;
+        if (threadPoolSubmit(context->pool, axisTask, &file->axes[i]) != 0) {
+            axisTask(&file->axes[i], workerIndex); // 無法排入佇列時直接執行
+        }
+    }
+}
+
+int runBatch(const char* const* files, int fileCount, const BatchOptions* options, BatchReport* report) {
+    if (files == NULL || fileCount < 0 || options == NULL || report == NULL) {
+        return -1;
+    }
+    memset(report, 0, sizeof(*report));
+
+    BatchContext context;
+    memset(&context, 0, sizeof(context));
+    context.options = options;
+    atomic_init(&context.samplesProcessed, 0);
+    atomic_init(&context.filesFailed, 0);
+
+    if (options->outputDirectory != NULL && mkdir(options->outputDirectory, 0777) != 0 && errno != EEXIST) {
+        perror(options->outputDirectory);
+        return -1;
+    }
+    context.pool = threadPoolCreate(options->threadCount);
+    if (context.pool == NULL) {
+        return -1;
+    }
+    int threadCount = threadPoolSize(context.pool);
+    int mainSlot = threadCount;
+    context.scratch = calloc((size_t)threadCount + 1, sizeof(WorkerScratch));
+    FileJob* jobs = calloc((size_t)(fileCount > 0 ? fileCount : 1), sizeof(FileJob));
+    int result = context.scratch != NULL && jobs != NULL ? 0 : -1;
+    for (int i = 0; result == 0 && i <= mainSlot; ++i) {
+        if (dspContextInit(&context.scratch[i].context, 0) != 0
+            || pipelineInit(&context.scratch[i].pipeline, &context.scratch[i].context) != 0
+            || pipelineAddMovingAverage(&context.scratch[i].pipeline, options->windowSize) < 0) {
+            result = -1;
+        }
+    }
+
+    double start = monotonicSeconds();
+    for (int i = 0; result == 0 && i < fileCount; ++i) {
+        jobs[i].context = &context;
+        jobs[i].path = files[i];
+        if (threadPoolSubmit(context.pool, loadTask, &jobs[i]) != 0) {
+            loadTask(&jobs[i], mainSlot); // 不能借用 worker 0 的暫存空間，它可能正在執行
+        }
+    }
+    threadPoolWait(context.pool);
+    double elapsed = monotonicSeconds() - start;
+    threadPoolDestroy(context.pool);
+
+    for (int i = 0; context.scratch != NULL && i <= mainSlot; ++i) {
+        pipelineFree(&context.scratch[i].pipeline);
+        dspContextFree(&context.scratch[i].context);
+    }
+    free(context.scratch);
+    free(jobs);
+    if (result != 0) {
+        return -1;
+    }
+
+    report->filesFailed = atomic_load(&context.filesFailed);
+    report->filesProcessed = fileCount - report->filesFailed;
+    report->samplesProcessed = atomic_load(&context.samplesProcessed);
+    report->seconds = elapsed;
+    report->samplesPerSecond = elapsed > 0 ? (double)report->samplesProcessed / elapsed : 0.0;
+    report->threadCount = threadCount;
+    return report->filesFailed == 0 ? 0 : 1;
+}
+
+static int appendPath(char*** files, int* count, int* capacity, const char* path) {
+    if (*count == *capacity) {
+        int newCapacity = *capacity > 0 ? *capacity * 2 : 64;
+        char** grown = realloc(*files, sizeof(char*) * (size_t)newCapacity);
+        if (grown == NULL) {
+            return -1;
+        }
+        *files = grown;
+        *capacity = newCapacity;
+    }
+    char* copy = strdup(path);
+    if (copy == NULL) {
+        return -1;
+    }
+    (*files)[(*count)++] = copy;
+    return 0;
+}
+
+static int comparePaths(const void* a, const void* b) {
+    return strcmp(*(char* const*)a, *(char* const*)b);
+}
+
+static int hasCsvExtension(const char* name) {
+    size_t length = strlen(name);
+    return length > 4 && strcmp(name + length - 4, ".csv") == 0;
+}
+
+int collectBatchInputs(const char* path, char*** files, int* fileCount) {
+    if (path == NULL || files == NULL || fileCount == NULL) {
+        return -1;
+    }
+    *files = NULL;
+    *fileCount = 0;
+    int capacity = 0;
+
+    struct stat st;
+    if (stat(path, &st) != 0) {
+        perror(path);
+        return -1;
+    }
+
+    if (S_ISDIR(st.st_mode)) {
+        DIR* directory = opendir(path);
+        if (directory == NULL) {
+            perror(path);
+            return -1;
+        }
+        struct dirent* entry;
+        while ((entry = readdir(directory)) != NULL) {
+            if (!hasCsvExtension(entry->d_name)) {
+                continue;
+            }
+            char fullPath[4096];
+            snprintf(fullPath, sizeof(fullPath), "%s/%s", path, entry->d_name);
+            if (appendPath(files, fileCount, &capacity, fullPath) != 0) {
+                closedir(directory);
+                freeBatchInputs(*files, *fileCount);
+                return -1;
+            }
+        }
+        closedir(directory);
+        qsort(*files, (size_t)*fileCount, sizeof(char*), comparePaths);
+        return 0;
+    }
+
+    // 清單檔：每行一個路徑
+    FILE* list = fopen(path, "r");
+    if (list == NULL) {
+        perror(path);
+        return -1;
+    }
+    char line[4096];
+    while (fgets(line, sizeof(line), list)) {
+        size_t length = strcspn(line, "\r\n");
+        line[length] = '\0';
+        if (length == 0) {
+            continue;
+        }
+        if (appendPath(files, fileCount, &capacity, line) != 0) {
+            fclose(list);
+            freeBatchInputs(*files, *fileCount);
+            return -1;
+        }
+    }
+    fclose(list);
+    return 0;
+}
+
+void freeBatchInputs(char** files, int fileCount) {
+    for (int i = 0; files != NULL && i < fileCount; ++i) {
+        free(files[i]);
+    }
+    free(files);
+}
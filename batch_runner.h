@@ -0,0 +1,67 @@
+// batch_runner.h
+
+#ifndef BATCH_RUNNER_H
+#define BATCH_RUNNER_H
+
+/**
+ * Settings for runBatch().
+ */
+typedef struct {
+    int threadCount;     // worker threads; 0 uses every online CPU
+    int windowSize;      // moving-average window applied to every axis
+    int maxRows;         // per-column row cap passed to loadCsvColumns(), 0 = no limit
+    const char* outputDirectory; // where the .cdsp results go (created if missing); NULL = next to each input
+} BatchOptions;
+
+/**
+ * Aggregate results of runBatch().
+ */
+typedef struct {
+    int filesProcessed;
+    int filesFailed;
+    long long samplesProcessed;  // samples across all files and axes
+    double seconds;              // wall-clock time of the whole batch
+    double samplesPerSecond;
+    int threadCount;
+} BatchReport;
+
+/**
+ * Processes many recordings concurrently on a work-stealing thread pool.
+ *
+ * Each file becomes one load task; once loaded, it spawns one task per axis (AX..GZ),
+ * which idle workers steal, so parallelism spans both files and the axes of a single
+ * file. Every worker owns a DspContext holding its Pipeline and reuses it for all the
+ * tasks it runs; each axis is filtered in place in the loaded columns, so steady-state
+ * processing does no per-axis allocation. When the last axis of a file is done, the six
+ * filtered axes are written as float64 columns "AX".."GZ" to a column file (see
+ * column_file.h) named after the input with ".csv" replaced by ".cdsp".
+ *
+ * A file counts as failed if it cannot be read, has no values for one of the axes, an
+ * axis fails to filter or its output cannot be written.
+ *
+ * @param files Paths of the CSV files to process.
+ * @param fileCount Number of entries in files.
+ * @param options Thread count and processing parameters.
+ * @param report Receives counts and throughput.
+ *
+ * @return 0 if every file was processed, 1 if some files failed, -1 if the pool or
+ *         worker scratch could not be created.
+ */
+int runBatch(const char* const* files, int fileCount, const BatchOptions* options, BatchReport* report);
+
+/**
+ * Expands a batch input argument into a list of files.
+ *
+ * If path is a directory, every "*.csv" file in it is returned in name order. Otherwise
+ * path is read as a list file with one CSV path per line (blank lines ignored).
+ *
+ * @param files Receives a malloc'd array of malloc'd paths; release with freeBatchInputs().
+ * @param fileCount Receives the number of paths.
+ *
+ * @return 0 on success, -1 if path cannot be read.
+ */
+int collectBatchInputs(const char* path, char*** files, int* fileCount);
+
+void freeBatchInputs(char** files, int fileCount);
+
+#endif // BATCH_RUNNER_H
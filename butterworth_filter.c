@@ -0,0 +1,251 @@
+// butterworth_filter.c
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <complex.h>
+
+#include "butterworth_filter.h"
+#include "dsp_kernels.h"
+
+// x86-64 Linux 上同時編譯 AVX2 與通用版本，執行時自動選擇
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__) && defined(__linux__)
+#define BIQUAD_TARGET_CLONES __attribute__((target_clones("avx2", "default")))
+#else
+#define BIQUAD_TARGET_CLONES
+#endif
+
+// 以兩個數位極點組成一個二階節的分母
+static void setSectionPoles(BiquadCoefficients* section, double complex poleA, double complex poleB) {
+    section->a1 = -creal(poleA + poleB);
+    section->a2 = creal(poleA * poleB);
+}
+
+static double complex bilinear(double complex analogPole, double fs2) {
+    return (fs2 + analogPole) / (fs2 - analogPole);
+}
+
+// 將每一節在參考頻率的增益正規化為 1
+static void normalizeSection(BiquadCoefficients* section, double complex zRef) {
+    double complex zInv = 1.0 / zRef;
+    double complex numerator = section->b0 + section->b1 * zInv + section->b2 * zInv * zInv;
+    double complex denominator = 1.0 + section->a1 * zInv + section->a2 * zInv * zInv;
+    double gain = cabs(numerator / denominator);
+    if (gain > 0) {
+        section->b0 /= gain;
+        section->b1 /= gain;
+        section->b2 /= gain;
+    }
+}
+
+int butterworthDesign(BiquadCascade* cascade, ButterworthType type, int order, double lowCutoff, double highCutoff, double samplingRate, int channelCount) {
+    if (cascade == NULL || order <= 0 || samplingRate <= 0 || lowCutoff <= 0 || lowCutoff >= samplingRate / 2
+        || channelCount <= 0 || channelCount > BIQUAD_MAX_CHANNELS) {
+        return -1;
+    }
+    if (type == BUTTERWORTH_BAND_PASS) {
+        if (order > BIQUAD_MAX_SECTIONS || highCutoff <= lowCutoff || highCutoff >= samplingRate / 2) {
+            return -1;
+        }
+    } else if (order > 2 * BIQUAD_MAX_SECTIONS) {
+        return -1;
+    }
+
+    memset(cascade, 0, sizeof(*cascade));
+    cascade->channelCount = channelCount;
+
+    // 預扭曲後的類比截止角頻率，雙線性轉換使用 2*fs
+    double fs2 = 2.0 * samplingRate;
+    double wLow = fs2 * tan(DSP_PI * lowCutoff / samplingRate);
+    double complex zRef;
+    double b1;
+    double b2;
+    if (type == BUTTERWORTH_LOW_PASS) {
+        zRef = 1.0;            // 直流
+        b1 = 2.0;
+        b2 = 1.0;              // 零點在 z = -1
+    } else if (type == BUTTERWORTH_HIGH_PASS) {
+        zRef = -1.0;           // Nyquist
+        b1 = -2.0;
+        b2 = 1.0;              // 零點在 z = 1
+    } else {
+        b1 = 0.0;
+        b2 = -1.0;             // 零點在 z = 1 與 z = -1
+        zRef = 0.0;
+    }
+
+    if (type != BUTTERWORTH_BAND_PASS) {
+        // 巴特沃斯的高通極點與低通相同（單位圓上的極點取倒數後仍在同一組內），只有零點不同
+        int count = 0;
+        for (int k = 0; k < order / 2; ++k) {
+            double complex analogPole = wLow * cexp(I * DSP_PI * (2.0 * k + order + 1) / (2.0 * order));
+            double complex pole = bilinear(analogPole, fs2);
+            BiquadCoefficients* section = &cascade->sections[count++];
+            section->b0 = 1.0;
+            section->b1 = b1;
+            section->b2 = b2;
+            setSectionPoles(section, pole, conj(pole));
+            normalizeSection(section, zRef);
+        }
+        if (order % 2 == 1) {
+            // 奇數階：實數極點形成一階節
+            double pole = creal(bilinear(-wLow, fs2));
+            BiquadCoefficients* section = &cascade->sections[count++];
+            section->b0 = 1.0;
+            section->b1 = type == BUTTERWORTH_LOW_PASS ? 1.0 : -1.0;
+            section->b2 = 0.0;
+            section->a1 = -pole;
+            section->a2 = 0.0;
+            normalizeSection(section, zRef);
+        }
+        cascade->sectionCount = count;
+        return 0;
+    }
+
+    // 帶通：原型極點 p 轉換為 s = p*bw/2 ± sqrt((p*bw/2)^2 - w0^2)
+    double wHigh = fs2 * tan(DSP_PI * highCutoff / samplingRate);
+    double w0 = sqrt(wLow * wHigh);
+    double bandwidth = wHigh - wLow;
+    zRef = cexp(I * 2.0 * atan(w0 / fs2));
+    int count = 0;
+    for (int k = 0; k < (order + 1) / 2; ++k) {
+        double complex prototype = cexp(I * DSP_PI * (2.0 * k + order + 1) / (2.0 * order));
+        double complex half = prototype * bandwidth / 2.0;
+        double complex root = csqrt(half * half - w0 * w0);
+        double complex poleA = bilinear(half + root, fs2);
+        double complex poleB = bilinear(half - root, fs2);
+        if (2 * k + 1 == order) {
+            // 實數原型極點：兩個帶通極點互為共軛（或皆為實數），組成一節
+            BiquadCoefficients* section = &cascade->sections[count++];
+            section->b0 = 1.0;
+            section->b1 = b1;
+            section->b2 = b2;
+            setSectionPoles(section, poleA, poleB);
+            normalizeSection(section, zRef);
+        } else {
+            double complex poles[2] = {poleA, poleB};
+            for (int j = 0; j < 2; ++j) {
+                BiquadCoefficients* section = &cascade->sections[count++];
+                section->b0 = 1.0;
+                section->b1 = b1;
+                section->b2 = b2;
+                setSectionPoles(section, poles[j], conj(poles[j]));
+                normalizeSection(section, zRef);
+            }
+        }
+    }
+    cascade->sectionCount = count;
+    return 0;
+}
+
+void biquadCascadeReset(BiquadCascade* cascade) {
+    if (cascade == NULL) {
+        return;
+    }
+    memset(cascade->z1, 0, sizeof(cascade->z1));
+    memset(cascade->z2, 0, sizeof(cascade->z2));
+}
+
+/*
+ * Core loop: one sample of every channel per iteration, sections in sequence. The
+ * channel loop has a fixed trip count of BIQUAD_MAX_CHANNELS over contiguous state, so
+ * the compiler turns it into full-width vector operations.
+ */
+BIQUAD_TARGET_CLONES
+static void runCascade(BiquadCascade* cascade, const double* const* inputData, double* const* outputData, int dataSize, int reverse) {
+    const int channelCount = cascade->channelCount;
+    const int sectionCount = cascade->sectionCount;
+    double lanes[BIQUAD_MAX_CHANNELS] = {0};
+
+    for (int n = 0; n < dataSize; ++n) {
+        int i = reverse ? dataSize - 1 - n : n;
+        for (int ch = 0; ch < channelCount; ++ch) {
+            lanes[ch] = inputData[ch][i];
+        }
+        for (int s = 0; s < sectionCount; ++s) {
+            const BiquadCoefficients c = cascade->sections[s];
+            double* z1 = cascade->z1[s];
+            double* z2 = cascade->z2[s];
+            for (int ch = 0; ch < BIQUAD_MAX_CHANNELS; ++ch) {
+                double x = lanes[ch];
+                double y = c.b0 * x + z1[ch];
+                z1[ch] = c.b1 * x - c.a1 * y + z2[ch];
+                z2[ch] = c.b2 * x - c.a2 * y;
+                lanes[ch] = y;
+            }
+        }
+        for (int ch = 0; ch < channelCount; ++ch) {
+            outputData[ch][i] = lanes[ch];
+        }
+    }
+}
+
+void biquadCascadeProcess(BiquadCascade* cascade, const double* const* inputData, double* const* outputData, int dataSize) {
+    if (cascade == NULL || inputData == NULL || outputData == NULL || dataSize <= 0) {
+        return;
+    }
+    runCascade(cascade, inputData, outputData, dataSize, 0);
+}
+
+// 將狀態設為輸入恆為 x 時的穩態，避免起始暫態
+static void setSteadyState(BiquadCascade* cascade, const double* first) {
+    for (int ch = 0; ch < BIQUAD_MAX_CHANNELS; ++ch) {
+        double x = ch < cascade->channelCount ? first[ch] : 0.0;
+        for (int s = 0; s < cascade->sectionCount; ++s) {
+            const BiquadCoefficients* c = &cascade->sections[s];
+            double dcGain = (c->b0 + c->b1 + c->b2) / (1.0 + c->a1 + c->a2);
+            double y = dcGain * x;
+            cascade->z1[s][ch] = y - c->b0 * x;
+            cascade->z2[s][ch] = c->b2 * x - c->a2 * y;
+            x = y;
+        }
+    }
+}
+
+int biquadCascadeFiltFilt(BiquadCascade* cascade, const double* const* inputData, double* const* outputData, int dataSize, DspContext* context) {
+    if (cascade == NULL || inputData == NULL || outputData == NULL || dataSize <= 0) {
+        return -1;
+    }
+
+    // 兩端以奇對稱延伸，長度與 scipy.signal.filtfilt 的預設相同
+    int padLength = 3 * (2 * cascade->sectionCount + 1);
+    if (padLength > dataSize - 1) {
+        padLength = dataSize - 1;
+    }
+    int extendedSize = dataSize + 2 * padLength;
+    DspContextMark mark;
+    double* scratch = dspContextScratch(context, sizeof(double) * (size_t)extendedSize * (size_t)cascade->channelCount, &mark);
+    if (scratch == NULL) {
+        dspContextScratchRelease(context, scratch, &mark);
+        return -1;
+    }
+
+    double* extended[BIQUAD_MAX_CHANNELS];
+    double edge[BIQUAD_MAX_CHANNELS] = {0};
+    for (int ch = 0; ch < cascade->channelCount; ++ch) {
+        const double* x = inputData[ch];
+        double* e = scratch + (size_t)ch * (size_t)extendedSize;
+        for (int k = 0; k < padLength; ++k) {
+            e[k] = 2 * x[0] - x[padLength - k];
+            e[padLength + dataSize + k] = 2 * x[dataSize - 1] - x[dataSize - 2 - k];
+        }
+        memcpy(e + padLength, x, sizeof(double) * (size_t)dataSize);
+        extended[ch] = e;
+        edge[ch] = e[0];
+    }
+
+    setSteadyState(cascade, edge);
+    runCascade(cascade, (const double* const*)extended, extended, extendedSize, 0);
+
+    for (int ch = 0; ch < cascade->channelCount; ++ch) {
+        edge[ch] = extended[ch][extendedSize - 1];
+    }
+    setSteadyState(cascade, edge);
+    runCascade(cascade, (const double* const*)extended, extended, extendedSize, 1);
+
+    for (int ch = 0; ch < cascade->channelCount; ++ch) {
+        memcpy(outputData[ch], extended[ch] + padLength, sizeof(double) * (size_t)dataSize);
+    }
+    dspContextScratchRelease(context, scratch, &mark);
+    biquadCascadeReset(cascade);
+    return 0;
+}
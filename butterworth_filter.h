@@ -0,0 +1,117 @@
+// butterworth_filter.h
+
+#ifndef BUTTERWORTH_FILTER_H
+#define BUTTERWORTH_FILTER_H
+
+#include "dsp_context.h"
+
+/**
+ * Maximum number of second-order sections in a cascade. A low-pass or high-pass filter
+ * of order N uses (N + 1) / 2 sections, a band-pass filter of order N uses N sections.
+ */
+#define BIQUAD_MAX_SECTIONS 8
+
+/**
+ * Number of channels processed side by side. The state is stored struct-of-arrays with
+ * this many lanes per section, so one cascade filters AX, AY, AZ, GX, GY and GZ in a
+ * single vectorized loop. Unused lanes are padded with zeros.
+ */
+#define BIQUAD_MAX_CHANNELS 8
+
+typedef enum {
+    BUTTERWORTH_LOW_PASS,
+    BUTTERWORTH_HIGH_PASS,
+    BUTTERWORTH_BAND_PASS
+} ButterworthType;
+
+/**
+ * Coefficients of one section, normalized so that a0 = 1:
+ *     H(z) = (b0 + b1 z^-1 + b2 z^-2) / (1 + a1 z^-1 + a2 z^-2)
+ */
+typedef struct {
+    double b0, b1, b2;
+    double a1, a2;
+} BiquadCoefficients;
+
+/**
+ * A cascade of biquad sections shared by up to BIQUAD_MAX_CHANNELS channels.
+ *
+ * Every channel sees the same coefficients but keeps its own transposed direct form II
+ * state (z1, z2), laid out [section][channel] so that the channel loop vectorizes.
+ * State is carried across biquadCascadeProcess() calls, so long recordings and live
+ * streams can be filtered block by block.
+ */
+typedef struct {
+    BiquadCoefficients sections[BIQUAD_MAX_SECTIONS];
+    int sectionCount;
+    int channelCount;
+    double z1[BIQUAD_MAX_SECTIONS][BIQUAD_MAX_CHANNELS];
+    double z2[BIQUAD_MAX_SECTIONS][BIQUAD_MAX_CHANNELS];
+} BiquadCascade;
+
+/**
+ * Designs an Nth-order digital Butterworth filter as a cascade of biquads.
+ *
+ * The analog prototype is mapped with the bilinear transform after pre-warping the
+ * cutoff frequencies, so the -3 dB points land exactly on the requested frequencies.
+ * Each section is normalized to unity gain in the passband (DC for low-pass, Nyquist
+ * for high-pass, the geometric centre frequency for band-pass).
+ *
+ * @param cascade The cascade to initialize; its state is reset.
+ * @param type Low-pass, high-pass or band-pass.
+ * @param order Filter order N. 1..2*BIQUAD_MAX_SECTIONS for low/high-pass,
+ *              1..BIQUAD_MAX_SECTIONS for band-pass (which has order 2N overall).
+ * @param lowCutoff Cutoff frequency in Hz for low/high-pass, lower band edge for band-pass.
+ * @param highCutoff Upper band edge in Hz for band-pass, ignored otherwise.
+ * @param samplingRate The sampling rate in Hz. Every cutoff must be below samplingRate / 2.
+ * @param channelCount Number of channels, 1..BIQUAD_MAX_CHANNELS.
+ *
+ * @return 0 on success, -1 on invalid parameters.
+ *
+ * @note butterworthLowPassFilter() in data_processing.h remains available as the
+ *       first-order (RC) special case; an order-1 cascade uses the bilinear transform
+ *       and therefore differs slightly from it near Nyquist.
+ *
+ * Example usage:
+ *     BiquadCascade lowPass;
+ *     butterworthDesign(&lowPass, BUTTERWORTH_LOW_PASS, 4, 5.0, 0.0, 100.0, 6);
+ *     const double* in[6] = {ax, ay, az, gx, gy, gz};
+ *     double* out[6] = {fax, fay, faz, fgx, fgy, fgz};
+ *     biquadCascadeProcess(&lowPass, in, out, dataSize);
+ */
+int butterworthDesign(BiquadCascade* cascade, ButterworthType type, int order, double lowCutoff, double highCutoff, double samplingRate, int channelCount);
+
+/**
+ * Clears the filter state of every channel.
+ */
+void biquadCascadeReset(BiquadCascade* cascade);
+
+/**
+ * Filters dataSize samples of every channel, continuing from the current state.
+ *
+ * @param inputData Array of channelCount input arrays.
+ * @param outputData Array of channelCount output arrays; may alias inputData.
+ * @param dataSize The number of samples per channel.
+ */
+void biquadCascadeProcess(BiquadCascade* cascade, const double* const* inputData, double* const* outputData, int dataSize);
+
+/**
+ * Zero-phase filtering: runs the cascade forward, then backward over the result.
+ *
+ * The magnitude response is squared and the phase shift cancels, so features are not
+ * delayed. To suppress transients at both ends the signal is extended by an odd
+ * reflection of 3 * (2 * sectionCount + 1) samples (as scipy.signal.filtfilt does) and
+ * each pass starts from the steady-state response to its first sample. The state is
+ * reset when the function returns. Unlike biquadCascadeProcess() this needs the whole
+ * recording and cannot be used on a live stream.
+ *
+ * @param inputData Array of channelCount input arrays.
+ * @param outputData Array of channelCount output arrays; may alias inputData.
+ * @param dataSize The number of samples per channel.
+ * @param context Arena for the padded copy of the signal, or NULL to use the heap.
+ *
+ * @return 0 on success, -1 on invalid arguments or if the padding buffer cannot be allocated.
+ */
+int biquadCascadeFiltFilt(BiquadCascade* cascade, const double* const* inputData, double* const* outputData, int dataSize, DspContext* context);
+
+#endif // BUTTERWORTH_FILTER_H
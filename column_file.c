@@ -0,0 +1,197 @@
+// column_file.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "column_file.h"
+#include "dsp_stats.h"
+
+_Static_assert(sizeof(ColumnFileHeader) == 64, "ColumnFileHeader must be 64 bytes");
+_Static_assert(sizeof(ColumnDescriptor) == 64, "ColumnDescriptor must be 64 bytes");
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "column_file.c writes values in host byte order and requires a little-endian target"
+#endif
+
+static uint64_t alignUp(uint64_t value) {
+    return (value + COLUMN_FILE_ALIGNMENT - 1) & ~(uint64_t)(COLUMN_FILE_ALIGNMENT - 1);
+}
+
+int columnDataTypeSize(ColumnDataType dtype) {
+    switch (dtype) {
+    case COLUMN_DTYPE_FLOAT64:
+        return 8;
+    case COLUMN_DTYPE_FLOAT32:
+    case COLUMN_DTYPE_INT32:
+        return 4;
+    case COLUMN_DTYPE_INT16:
+        return 2;
+    }
+    return 0;
+}
+
+int writeColumnFile(const char* path, double sampleRate, int rowCount, const ColumnSpec* columns, int columnCount, uint64_t* columnOffsets) {
+    if (path == NULL || rowCount < 0 || columns == NULL || columnCount <= 0) {
+        return -1;
+    }
+
+    // 標頭與欄位描述一次組好後寫出
+    size_t metaSize = sizeof(ColumnFileHeader) + sizeof(ColumnDescriptor) * (size_t)columnCount;
+    uint8_t* meta = calloc(1, metaSize);
+    if (meta == NULL) {
+        return -1;
+    }
+    ColumnFileHeader* header = (ColumnFileHeader*)meta;
+    ColumnDescriptor* descriptors = (ColumnDescriptor*)(meta + sizeof(ColumnFileHeader));
+    memcpy(header->magic, COLUMN_FILE_MAGIC, sizeof(header->magic));
+    header->version = COLUMN_FILE_VERSION;
+    header->columnCount = (uint32_t)columnCount;
+    header->rowCount = (uint64_t)rowCount;
+    header->sampleRate = sampleRate;
+
+    uint64_t offset = alignUp(metaSize);
+    for (int i = 0; i < columnCount; ++i) {
+        int elementSize = columnDataTypeSize(columns[i].dtype);
+        if (elementSize == 0 || columns[i].name == NULL || (columns[i].data == NULL && rowCount > 0)
+            || (uint64_t)rowCount > SIZE_MAX / (uint64_t)elementSize) {
+            free(meta);
+            return -1;
+        }
+        strncpy(descriptors[i].name, columns[i].name, COLUMN_FILE_NAME_LENGTH - 1);
+        descriptors[i].dtype = (uint32_t)columns[i].dtype;
+        descriptors[i].offset = offset;
+        descriptors[i].byteLength = (uint64_t)rowCount * (uint64_t)elementSize;
+        if (columnOffsets != NULL) {
+            columnOffsets[i] = offset;
+        }
+        offset = alignUp(offset + descriptors[i].byteLength);
+    }
+
+    DSP_STATS_TIMER_BEGIN(timer);
+    FILE* file = fopen(path, "wb");
+    if (file == NULL) {
+        perror(path);
+        free(meta);
+        return -1;
+    }
+
+    static const uint8_t zeros[COLUMN_FILE_ALIGNMENT] = {0};
+    int ok = fwrite(meta, 1, metaSize, file) == metaSize;
+    uint64_t position = metaSize;
+    for (int i = 0; ok && i < columnCount; ++i) {
+        size_t padding = (size_t)(descriptors[i].offset - position);
+        ok = fwrite(zeros, 1, padding, file) == padding;
+        size_t length = (size_t)descriptors[i].byteLength;
+        // 直接從呼叫者的陣列寫出，不做逐值轉換
+        ok = ok && (length == 0 || fwrite(columns[i].data, 1, length, file) == length);
+        position = descriptors[i].offset + descriptors[i].byteLength;
+    }
+    if (fclose(file) != 0) {
+        ok = 0;
+    }
+    DSP_STATS_TIMER_END(timer, DSP_STAGE_TEMP_WRITE);
+    if (ok) {
+        DSP_STATS_ADD(DSP_COUNTER_BYTES_WRITTEN, position);
+    }
+    free(meta);
+    return ok ? 0 : -1;
+}
+
+int openColumnFile(const char* path, ColumnFile* file) {
+    if (path == NULL || file == NULL) {
+        return -1;
+    }
+    memset(file, 0, sizeof(*file));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        perror(path);
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (uint64_t)st.st_size < sizeof(ColumnFileHeader)) {
+        close(fd);
+        return -1;
+    }
+    void* map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        return -1;
+    }
+
+    file->base = map;
+    file->size = (uint64_t)st.st_size;
+    file->header = map;
+    file->columns = (const ColumnDescriptor*)(file->base + sizeof(ColumnFileHeader));
+
+    // 驗證標頭與每個欄位都落在檔案範圍內
+    const ColumnFileHeader* header = file->header;
+    int valid = memcmp(header->magic, COLUMN_FILE_MAGIC, sizeof(header->magic)) == 0
+        && header->version == COLUMN_FILE_VERSION
+        && sizeof(ColumnFileHeader) + sizeof(ColumnDescriptor) * (uint64_t)header->columnCount <= file->size;
+    for (uint32_t i = 0; valid && i < header->columnCount; ++i) {
+        const ColumnDescriptor* column = &file->columns[i];
+        int elementSize = columnDataTypeSize((ColumnDataType)column->dtype);
+        // 先排除乘積溢位，否則偽造的 rowCount 可能繞回與 byteLength 相等
+        valid = elementSize > 0
+            && header->rowCount <= UINT64_MAX / (uint64_t)elementSize
+            && column->byteLength == header->rowCount * (uint64_t)elementSize
+            && column->offset % COLUMN_FILE_ALIGNMENT == 0
+            && column->offset <= file->size
+            && column->byteLength <= file->size - column->offset
+            && memchr(column->name, '\0', COLUMN_FILE_NAME_LENGTH) != NULL;
+    }
+    if (!valid) {
+        fprintf(stderr, "%s: not a valid column file\n", path);
+        closeColumnFile(file);
+        return -1;
+    }
+    return 0;
+}
+
+int columnFileFind(const ColumnFile* file, const char* name) {
+    if (file == NULL || file->header == NULL || name == NULL) {
+        return -1;
+    }
+    for (uint32_t i = 0; i < file->header->columnCount; ++i) {
+        if (strcmp(file->columns[i].name, name) == 0) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+const void* columnFileData(const ColumnFile* file, int index) {
+    if (file == NULL || file->header == NULL || index < 0 || (uint32_t)index >= file->header->columnCount) {
+        return NULL;
+    }
+    return file->base + file->columns[index].offset;
+}
+
+const double* columnFileDoubles(const ColumnFile* file, const char* name) {
+    int index = columnFileFind(file, name);
+    if (index < 0 || file->columns[index].dtype != COLUMN_DTYPE_FLOAT64) {
+        return NULL;
+    }
+    return columnFileData(file, index);
+}
+
+int columnFileGnuplotSource(const char* path, uint64_t offset, uint64_t rowCount, char* buffer, int bufferSize) {
+    int length = snprintf(buffer, (size_t)bufferSize, "'%s' binary skip=%llu array=%llu format='%%float64' endian=little",
+                          path, (unsigned long long)offset, (unsigned long long)rowCount);
+    return length >= 0 && length < bufferSize ? 0 : -1;
+}
+
+void closeColumnFile(ColumnFile* file) {
+    if (file == NULL) {
+        return;
+    }
+    if (file->base != NULL) {
+        munmap((void*)file->base, (size_t)file->size);
+    }
+    memset(file, 0, sizeof(*file));
+}
@@ -0,0 +1,138 @@
+// column_file.h
+
+#ifndef COLUMN_FILE_H
+#define COLUMN_FILE_H
+
+#include <stdint.h>
+
+/*
+ * Binary columnar file format (".cdsp"), little-endian:
+ *
+ *   offset 0   ColumnFileHeader      (64 bytes)
+ *   offset 64  ColumnDescriptor[n]   (64 bytes each)
+ *   ...        column data, each column contiguous and starting on a 64-byte boundary
+ *
+ * Values are stored raw (no text formatting, no precision loss), so a file can be
+ * memory-mapped and its columns used in place as arrays, and gnuplot can plot a column
+ * directly with its binary input mode (see columnFileGnuplotSource()).
+ */
+
+#define COLUMN_FILE_MAGIC "CDSPCOL1"
+#define COLUMN_FILE_VERSION 1
+#define COLUMN_FILE_NAME_LENGTH 32
+#define COLUMN_FILE_ALIGNMENT 64
+
+typedef enum {
+    COLUMN_DTYPE_FLOAT64 = 1,
+    COLUMN_DTYPE_FLOAT32 = 2,
+    COLUMN_DTYPE_INT16 = 3,
+    COLUMN_DTYPE_INT32 = 4
+} ColumnDataType;
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t columnCount;
+    uint64_t rowCount;
+    double sampleRate;        // Hz, 0 if unknown
+    uint8_t reserved[32];
+} ColumnFileHeader;
+
+typedef struct {
+    char name[COLUMN_FILE_NAME_LENGTH];   // NUL-terminated
+    uint32_t dtype;                       // ColumnDataType
+    uint32_t reserved;
+    uint64_t offset;                      // absolute file offset of the first value
+    uint64_t byteLength;
+    uint8_t padding[8];
+} ColumnDescriptor;
+
+/**
+ * One column to write: a name, its element type and a pointer to rowCount values.
+ */
+typedef struct {
+    const char* name;
+    ColumnDataType dtype;
+    const void* data;
+} ColumnSpec;
+
+/**
+ * @return The size in bytes of one value of dtype, or 0 for an unknown type.
+ */
+int columnDataTypeSize(ColumnDataType dtype);
+
+/**
+ * Writes columns to path in the binary columnar format.
+ *
+ * Only the header and descriptors are formatted; each column is written straight from
+ * the caller's array with a single fwrite(), so there is no per-value conversion.
+ *
+ * @param path Destination file, overwritten if it exists.
+ * @param sampleRate Sampling rate stored in the header (0 if unknown).
+ * @param rowCount Number of values in every column.
+ * @param columns Columns to write; names longer than 31 characters are truncated.
+ * @param columnCount Number of entries in columns.
+ * @param columnOffsets Optional (may be NULL); receives the file offset of each column,
+ *                      e.g. for columnFileGnuplotSource().
+ *
+ * @return 0 on success, -1 on invalid arguments or I/O error.
+ *
+ * Example usage:
+ *     ColumnSpec columns[] = {
+ *         {"input", COLUMN_DTYPE_FLOAT64, inputData},
+ *         {"output", COLUMN_DTYPE_FLOAT64, outputData},
+ *     };
+ *     writeColumnFile("tempData_AX.cdsp", 50.0, count, columns, 2, NULL);
+ */
+int writeColumnFile(const char* path, double sampleRate, int rowCount, const ColumnSpec* columns, int columnCount, uint64_t* columnOffsets);
+
+/**
+ * A memory-mapped column file opened for reading.
+ */
+typedef struct {
+    const uint8_t* base;
+    uint64_t size;
+    const ColumnFileHeader* header;
+    const ColumnDescriptor* columns;
+} ColumnFile;
+
+/**
+ * Maps a column file and validates its header and column bounds.
+ *
+ * @return 0 on success, -1 if the file cannot be read or is not a valid column file.
+ */
+int openColumnFile(const char* path, ColumnFile* file);
+
+/**
+ * @return The index of the column called name, or -1 if there is none.
+ */
+int columnFileFind(const ColumnFile* file, const char* name);
+
+/**
+ * @return A pointer to the values of column index inside the mapping (aligned to 64
+ *         bytes), or NULL if index is out of range. Valid until closeColumnFile().
+ */
+const void* columnFileData(const ColumnFile* file, int index);
+
+/**
+ * Convenience accessor for float64 columns.
+ *
+ * @return The values of the named column, or NULL if it is missing or not float64.
+ */
+const double* columnFileDoubles(const ColumnFile* file, const char* name);
+
+/**
+ * Formats a gnuplot data source that reads one float64 column of a column file in
+ * binary mode, e.g. "'f.cdsp' binary skip=192 array=1464 format='%float64' endian=little".
+ * The x coordinate is the sample index.
+ *
+ * @param offset File offset of the column, from writeColumnFile() or a ColumnDescriptor.
+ * @param rowCount Number of values to plot.
+ *
+ * @return 0 on success, -1 if the buffer is too small.
+ */
+int columnFileGnuplotSource(const char* path, uint64_t offset, uint64_t rowCount, char* buffer, int bufferSize);
+
+void closeColumnFile(ColumnFile* file);
+
+#endif // COLUMN_FILE_H
@@ -0,0 +1,386 @@
+// csv_loader.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "csv_loader.h"
+#include "dsp_stats.h"
+
+// 10^0 .. 10^22 都可以被 double 精確表示
+static const double kPow10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static int isBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+static int parseWithStrtod(const char* begin, const char* end, double* value) {
+    char buffer[128];
+    size_t length = (size_t)(end - begin);
+    if (length == 0 || length >= sizeof(buffer)) {
+        return -1;
+    }
+    memcpy(buffer, begin, length);
+    buffer[length] = '\0';
+
+    char* parsedEnd = NULL;
+    *value = strtod(buffer, &parsedEnd);
+    return parsedEnd == buffer + length ? 0 : -1;
+}
+
+int parseCsvDouble(const char* begin, const char* end, double* value) {
+    while (begin < end && isBlank(*begin)) {
+        begin++;
+    }
+    while (end > begin && isBlank(end[-1])) {
+        end--;
+    }
+    if (begin == end) {
+        return -1;
+    }
+
+    const char* p = begin;
+    int negative = 0;
+    if (*p == '-' || *p == '+') {
+        negative = (*p == '-');
+        p++;
+    }
+
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    int sawDigit = 0;
+    for (; p < end && *p >= '0' && *p <= '9'; ++p) {
+        sawDigit = 1;
+        if (digits < 19) {
+            mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+            if (mantissa != 0) {
+                digits++;
+            }
+        } else {
+            exponent++;
+        }
+    }
+    if (p < end && *p == '.') {
+        p++;
+        for (; p < end && *p >= '0' && *p <= '9'; ++p) {
+            sawDigit = 1;
+            if (digits < 19) {
+                mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+                exponent--;
+                if (mantissa != 0) {
+                    digits++;
+                }
+            }
+        }
+    }
+    if (!sawDigit) {
+        return parseWithStrtod(begin, end, value); // inf / nan 等特殊值
+    }
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        p++;
+        int expNegative = 0;
+        if (p < end && (*p == '-' || *p == '+')) {
+            expNegative = (*p == '-');
+            p++;
+        }
+        if (p == end || *p < '0' || *p > '9') {
+            return -1;
+        }
+        int expValue = 0;
+        for (; p < end && *p >= '0' && *p <= '9'; ++p) {
+            if (expValue < 10000) {
+                expValue = expValue * 10 + (*p - '0');
+            }
+        }
+        exponent += expNegative ? -expValue : expValue;
+    }
+    if (p != end) {
+        return -1;
+    }
+
+    // Clinger 快速路徑：尾數與 10 的次方都可精確表示時，一次乘除即為正確捨入
+    if (digits >= 19 || mantissa > ((uint64_t)1 << 53) || exponent < -22 || exponent > 22) {
+        return parseWithStrtod(begin, end, value);
+    }
+    double result = (double)mantissa;
+    result = exponent < 0 ? result / kPow10[-exponent] : result * kPow10[exponent];
+    *value = negative ? -result : result;
+    return 0;
+}
+
+// 所有欄位共用一塊記憶體：每次成長只配置一次，並把各欄位複製到新的位置
+static int reserveColumns(CsvData* data, int capacity) {
+    double* storage = malloc(sizeof(double) * (size_t)capacity * (size_t)data->columnCount);
+    if (storage == NULL) {
+        return -1;
+    }
+    for (int i = 0; i < data->columnCount; ++i) {
+        CsvColumn* column = &data->columns[i];
+        double* moved = storage + (size_t)i * (size_t)capacity;
+        if (column->count > 0) {
+            memcpy(moved, column->data, sizeof(double) * (size_t)column->count);
+        }
+        column->data = moved;
+        column->capacity = capacity;
+    }
+    free(data->storage);
+    data->storage = storage;
+    DSP_STATS_ADD(DSP_COUNTER_BUFFER_ALLOCATIONS, 1);
+    return 0;
+}
+
+static int appendValue(CsvData* data, CsvColumn* column, double value, int maxRows) {
+    if (maxRows > 0 && column->count >= maxRows) {
+        return 0;
+    }
+    if (column->count == column->capacity) {
+        if (column->capacity == INT_MAX) {
+            return -1;
+        }
+        int newCapacity = column->capacity < INT_MAX / 2 ? column->capacity * 2 : INT_MAX;
+        if (newCapacity < 1024) {
+            newCapacity = 1024;
+        }
+        if (maxRows > 0 && newCapacity > maxRows) {
+            newCapacity = maxRows;
+        }
+        if (reserveColumns(data, newCapacity) != 0) {
+            return -1;
+        }
+    }
+    column->data[column->count++] = value;
+    return 0;
+}
+
+// 以開頭至多 64 行的平均長度估計總行數，多留 1/16 的餘量
+static int estimateRows(const char* text, size_t size, int maxRows) {
+    const char* p = text;
+    const char* end = text + size;
+    int lines = 0;
+    while (p < end && lines < 64) {
+        const char* lineEnd = memchr(p, '\n', (size_t)(end - p));
+        p = lineEnd != NULL ? lineEnd + 1 : end;
+        lines++;
+    }
+    double estimate = 16.0;
+    if (lines > 0 && p > text) {
+        double perLine = (double)(p - text) / lines;
+        estimate += (double)size / perLine * (17.0 / 16.0);
+    }
+    if (maxRows > 0 && estimate > maxRows) {
+        estimate = maxRows;
+    }
+    return estimate < INT_MAX ? (int)estimate : INT_MAX;
+}
+
+// 讀取不能 mmap 的輸入（管道等）
+static char* readWholeFile(int fd, size_t* size) {
+    size_t capacity = 1 << 16;
+    size_t length = 0;
+    char* buffer = malloc(capacity);
+    if (buffer == NULL) {
+        return NULL;
+    }
+    for (;;) {
+        if (length == capacity) {
+            char* grown = realloc(buffer, capacity * 2);
+            if (grown == NULL) {
+                free(buffer);
+                return NULL;
+            }
+            buffer = grown;
+            capacity *= 2;
+            DSP_STATS_ADD(DSP_COUNTER_BUFFER_ALLOCATIONS, 1);
+        }
+        ssize_t n = read(fd, buffer + length, capacity - length);
+        if (n < 0) {
+            free(buffer);
+            return NULL;
+        }
+        if (n == 0) {
+            break;
+        }
+        length += (size_t)n;
+    }
+    *size = length;
+    return buffer;
+}
+
+static int parseBuffer(const char* text, size_t size, const int* slotOfColumn, int maxColumn, int maxRows, CsvData* data) {
+    const char* p = text;
+    const char* end = text + size;
+    int* seen = calloc((size_t)data->columnCount, sizeof(int));
+    if (seen == NULL) {
+        return -1;
+    }
+
+    while (p < end) {
+        const char* lineEnd = memchr(p, '\n', (size_t)(end - p));
+        if (lineEnd == NULL) {
+            lineEnd = end;
+        }
+        if (lineEnd == p || (lineEnd - p == 1 && *p == '\r')) {
+            p = lineEnd + 1;
+            continue; // 跳過空行
+        }
+
+        memset(seen, 0, sizeof(int) * (size_t)data->columnCount);
+        int currentColumn = 0;
+        const char* field = p;
+        while (currentColumn <= maxColumn) {
+            const char* fieldEnd = memchr(field, ',', (size_t)(lineEnd - field));
+            if (fieldEnd == NULL) {
+                fieldEnd = lineEnd;
+            }
+            int slot = slotOfColumn[currentColumn];
+            if (slot >= 0) {
+                CsvColumn* column = &data->columns[slot];
+                double value;
+                if (parseCsvDouble(field, fieldEnd, &value) != 0) {
+                    value = 0.0; // 整個欄位不是數字（含 "1.5abc" 這類尾端雜字）時記為 0 並計入錯誤
+                    column->parseErrors++;
+                }
+                if (appendValue(data, column, value, maxRows) != 0) {
+                    free(seen);
+                    return -1;
+                }
+                seen[slot] = 1;
+            }
+            if (fieldEnd == lineEnd) {
+                break;
+            }
+            field = fieldEnd + 1;
+            currentColumn++;
+        }
+        for (int i = 0; i < data->columnCount; ++i) {
+            if (!seen[i]) {
+                data->columns[i].parseErrors++; // 這一行缺少此列
+            }
+        }
+
+        data->totalRows++;
+        p = lineEnd + 1;
+    }
+
+    free(seen);
+    return 0;
+}
+
+static int loadColumns(const char* filename, const int* columnIndices, int columnCount, int maxRows, CsvData* data) {
+    if (filename == NULL || columnIndices == NULL || columnCount <= 0 || data == NULL) {
+        return -1;
+    }
+    memset(data, 0, sizeof(*data));
+
+    int maxColumn = 0;
+    for (int i = 0; i < columnCount; ++i) {
+        if (columnIndices[i] < 0) {
+            return -1;
+        }
+        if (columnIndices[i] > maxColumn) {
+            maxColumn = columnIndices[i];
+        }
+    }
+
+    int* slotOfColumn = malloc(sizeof(int) * (size_t)(maxColumn + 1));
+    data->columns = calloc((size_t)columnCount, sizeof(CsvColumn));
+    if (slotOfColumn == NULL || data->columns == NULL) {
+        free(slotOfColumn);
+        free(data->columns);
+        data->columns = NULL;
+        return -1;
+    }
+    data->columnCount = columnCount;
+    for (int i = 0; i <= maxColumn; ++i) {
+        slotOfColumn[i] = -1;
+    }
+    for (int i = 0; i < columnCount; ++i) {
+        if (slotOfColumn[columnIndices[i]] >= 0) {
+            // 重複的欄位只會填入其中一個位置，其餘位置將維持空白
+            fprintf(stderr, "Column %d requested more than once\n", columnIndices[i]);
+            free(slotOfColumn);
+            freeCsvData(data);
+            return -1;
+        }
+        data->columns[i].sourceColumn = columnIndices[i];
+        slotOfColumn[columnIndices[i]] = i;
+    }
+
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        perror("Unable to open file!");
+        free(slotOfColumn);
+        freeCsvData(data);
+        return -1;
+    }
+
+    struct stat st;
+    const char* text = NULL;
+    char* heapText = NULL;
+    size_t size = 0;
+    int mapped = 0;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        size = (size_t)st.st_size;
+        void* map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map != MAP_FAILED) {
+            madvise(map, size, MADV_SEQUENTIAL);
+            text = map;
+            mapped = 1;
+        }
+    }
+    if (!mapped) {
+        heapText = readWholeFile(fd, &size);
+        text = heapText;
+    }
+    close(fd);
+
+    int result = -1;
+    if (text != NULL) {
+        data->bytesRead = (long long)size;
+        result = reserveColumns(data, estimateRows(text, size, maxRows));
+        if (result == 0) {
+            result = parseBuffer(text, size, slotOfColumn, maxColumn, maxRows, data);
+        }
+    } else {
+        perror("Unable to read file!");
+    }
+
+    if (mapped) {
+        munmap((void*)text, size);
+    }
+    free(heapText);
+    free(slotOfColumn);
+    if (result != 0) {
+        freeCsvData(data);
+    }
+    return result;
+}
+
+int loadCsvColumns(const char* filename, const int* columnIndices, int columnCount, int maxRows, CsvData* data) {
+    DSP_STATS_TIMER_BEGIN(timer);
+    int result = loadColumns(filename, columnIndices, columnCount, maxRows, data);
+    DSP_STATS_TIMER_END(timer, DSP_STAGE_CSV_PARSE);
+    if (result == 0) {
+        DSP_STATS_ADD(DSP_COUNTER_BYTES_READ, data->bytesRead);
+        DSP_STATS_ADD(DSP_COUNTER_ROWS_PARSED, data->totalRows);
+    }
+    return result;
+}
+
+void freeCsvData(CsvData* data) {
+    if (data == NULL) {
+        return;
+    }
+    free(data->storage);
+    free(data->columns);
+    memset(data, 0, sizeof(*data));
+}
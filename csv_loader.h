@@ -0,0 +1,82 @@
+// csv_loader.h
+
+#ifndef CSV_LOADER_H
+#define CSV_LOADER_H
+
+/**
+ * One parsed CSV column, stored as a contiguous array (struct-of-arrays layout).
+ */
+typedef struct {
+    int sourceColumn;   // 0-based column index in the CSV file
+    double* data;       // parsed values, count entries
+    int count;          // number of values stored for this column
+    int capacity;       // allocated length of data (the same for every column)
+    int parseErrors;    // fields that were missing or not a valid number
+} CsvColumn;
+
+/**
+ * Result of loadCsvColumns(): one CsvColumn per requested column plus file totals.
+ */
+typedef struct {
+    CsvColumn* columns;
+    int columnCount;
+    double* storage;    // one block backing every column's data
+    int totalRows;      // number of non-empty lines in the file
+    long long bytesRead;
+} CsvData;
+
+/**
+ * Loads several columns of a CSV file in a single pass.
+ *
+ * The file is memory-mapped once (regular files) or read into memory once (pipes and
+ * other non-seekable inputs), and every line is tokenized a single time. Each requested
+ * column is parsed with a fast decimal parser and appended to its own array in
+ * data->columns, in the same order as columnIndices.
+ *
+ * There is no fixed row limit. All columns share one block sized from the line lengths
+ * at the start of the file, so most files need a single allocation; if the estimate is
+ * short, each doubling of the capacity is one allocation for all columns together.
+ *
+ * @param filename Path of the CSV file to read.
+ * @param columnIndices Array of distinct 0-based column indices to extract.
+ * @param columnCount Number of entries in columnIndices.
+ * @param maxRows Maximum number of values stored per column; further rows are still
+ *                counted in totalRows but their values are dropped. 0 means no limit.
+ * @param data Output structure; must be released with freeCsvData().
+ *
+ * @return 0 on success, -1 if columnIndices contains a negative or repeated index, the file
+ *         cannot be opened or read, or on allocation failure.
+ *
+ * @note Fields are parsed with parseCsvDouble(), which is stricter than atof(): the whole
+ *       field (apart from surrounding blanks) must be a decimal number, inf or nan, so
+ *       "1.5abc" or a hexadecimal value is rejected rather than partially read. A field that
+ *       is present but rejected is stored as 0.0; a field that is missing on a short line is
+ *       not stored at all. Both cases are counted in the column's parseErrors.
+ *
+ * Example usage:
+ *     int columns[] = {5, 6, 7};
+ *     CsvData csv;
+ *     if (loadCsvColumns("demo.csv", columns, 3, 0, &csv) == 0) {
+ *         // csv.columns[0].data holds column 5, ...
+ *         freeCsvData(&csv);
+ *     }
+ */
+int loadCsvColumns(const char* filename, const int* columnIndices, int columnCount, int maxRows, CsvData* data);
+
+/**
+ * Releases all memory owned by a CsvData filled by loadCsvColumns().
+ */
+void freeCsvData(CsvData* data);
+
+/**
+ * Parses a decimal floating-point number from [begin, end).
+ *
+ * Leading and trailing blanks are skipped. Numbers with at most 19 significant digits
+ * and a small exponent are converted exactly without calling strtod(); anything else
+ * falls back to strtod().
+ *
+ * @return 0 on success (result stored in *value), -1 if the field is not a valid number.
+ */
+int parseCsvDouble(const char* begin, const char* end, double* value);
+
+#endif // CSV_LOADER_H
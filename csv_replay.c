@@ -0,0 +1,162 @@
+// csv_replay.c
+// 依 column 0 的時間戳重播 CSV 記錄，用來測試 --live 模式
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "csv_loader.h"
+
+#define REPLAY_MAX_GAP 1.0   // 時間戳倒退或跳動超過此秒數時視為不連續
+
+static void printUsage(const char* programName) {
+    printf("Usage: %s <path_to_csv> [options]\n", programName);
+    printf("Streams the rows of a recording at the pace of their timestamps (column 0).\n");
+    printf("Options:\n");
+    printf("  --speed <factor>   Replay speed, 2 = twice as fast, 0 = as fast as possible (default: 1)\n");
+    printf("  --socket <path>    Listen on a UNIX socket and stream to the first client\n");
+    printf("                     (default: write to stdout, e.g. into a FIFO or a pipe)\n");
+    printf("  --loop <count>     Play the recording count times (default: 1)\n");
+    printf("  -h                 Display this help message and exit\n");
+}
+
+static int writeAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = write(fd, data, size);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return -1;
+        }
+        data += n;
+        size -= (size_t)n;
+    }
+    return 0;
+}
+
+static int acceptClient(const char* path) {
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(address.sun_path)) {
+        fprintf(stderr, "Socket path too long: %s\n", path);
+        return -1;
+    }
+    strcpy(address.sun_path, path);
+    int server = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (server < 0) {
+        perror("socket");
+        return -1;
+    }
+    unlink(path);
+    if (bind(server, (struct sockaddr*)&address, sizeof(address)) != 0 || listen(server, 1) != 0) {
+        perror(path);
+        close(server);
+        return -1;
+    }
+    fprintf(stderr, "Waiting for a client on %s\n", path);
+    int client = accept(server, NULL, NULL);
+    if (client < 0) {
+        perror("accept");
+    }
+    close(server);
+    unlink(path);
+    return client;
+}
+
+static void addSeconds(struct timespec* time, double seconds) {
+    long long nanoseconds = (long long)(seconds * 1e9) + time->tv_nsec;
+    time->tv_sec += (time_t)(nanoseconds / 1000000000LL);
+    time->tv_nsec = (long)(nanoseconds % 1000000000LL);
+}
+
+int main(int argc, char* argv[]) {
+    const char* filename = NULL;
+    const char* socketPath = NULL;
+    double speed = 1.0;
+    int loops = 1;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-h") == 0) {
+            printUsage(argv[0]);
+            return 0;
+        } else if (strcmp(argv[i], "--speed") == 0 && i + 1 < argc) {
+            speed = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--socket") == 0 && i + 1 < argc) {
+            socketPath = argv[++i];
+        } else if (strcmp(argv[i], "--loop") == 0 && i + 1 < argc) {
+            loops = atoi(argv[++i]);
+        } else if (argv[i][0] != '-' && filename == NULL) {
+            filename = argv[i];
+        } else {
+            fprintf(stderr, "Error: Unknown or incomplete argument '%s'.\n", argv[i]);
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (filename == NULL || speed < 0 || loops <= 0) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    FILE* file = fopen(filename, "r");
+    if (file == NULL) {
+        perror("Unable to open file!");
+        return 1;
+    }
+    signal(SIGPIPE, SIG_IGN); // 接收端關閉時以 write 錯誤結束
+    int out = socketPath != NULL ? acceptClient(socketPath) : STDOUT_FILENO;
+    if (out < 0) {
+        fclose(file);
+        return 1;
+    }
+
+    char* line = NULL;
+    size_t lineCapacity = 0;
+    long long rows = 0;
+    int status = 0;
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    for (int loop = 0; loop < loops && status == 0; loop++) {
+        rewind(file);
+        int havePrevious = 0;
+        double previous = 0.0;
+        ssize_t length;
+        while (status == 0 && (length = getline(&line, &lineCapacity, file)) > 0) {
+            // 每一行在上一行之後 (t - previous) / speed 秒送出
+            const char* comma = memchr(line, ',', (size_t)length);
+            double timestamp;
+            if (speed > 0 && parseCsvDouble(line, comma != NULL ? comma : line + length, &timestamp) == 0) {
+                double gap = havePrevious ? timestamp - previous : 0.0;
+                if (gap > 0 && gap <= REPLAY_MAX_GAP) {
+                    addSeconds(&deadline, gap / speed);
+                    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL) == EINTR) {
+                    }
+                }
+                previous = timestamp;
+                havePrevious = 1;
+            }
+            if (line[length - 1] != '\n') {
+                line[length++] = '\n'; // 最後一行沒有換行時補上，避免與下一輪的第一行相連
+            }
+            if (writeAll(out, line, (size_t)length) != 0) {
+                perror("Error writing stream");
+                status = 1;
+            }
+            rows++;
+        }
+    }
+    fprintf(stderr, "Replayed %lld rows\n", rows);
+
+    free(line);
+    fclose(file);
+    if (out != STDOUT_FILENO) {
+        close(out);
+    }
+    return status;
+}
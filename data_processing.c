@@ -1,8 +1,19 @@
 // data_processing.c
 #include <stddef.h>  // 或 #include <stdio.h> 或 #include <stdlib.h>
+#include <stdlib.h>
 #include <math.h>
 
 #include "data_processing.h"
+#include "dsp_kernels.h"
+#include "pedestrian.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define DP_X86_SIMD 1
+#else
+#define DP_X86_SIMD 0
+#endif
+
 /**
  * Calculates the moving average of the given input data.
  *
@@ -27,6 +38,13 @@
  *       The function handles boundary cases by averaging over the available elements
  *       at the start of the input array, which means the first few averages are based on
  *       fewer elements than the specified windowSize.
+ *       The window is maintained as a running sum with Neumaier compensated summation,
+ *       so outputs i >= windowSize cost O(1) each and long recordings do not drift.
+ *       The ramp-up outputs (i < windowSize) are summed newest to oldest like the original
+ *       O(dataSize * windowSize) loop and are bit-identical to it, at a cost of
+ *       O(min(dataSize, windowSize)^2); the total is O(dataSize + min(dataSize, windowSize)^2).
+ *       Later outputs differ from that loop only by rounding (a few ULPs, the compensated
+ *       sum being the more accurate of the two).
  *
  * Example usage:
  *     double data[] = {1.0, 2.0, 3.0, 4.0, 5.0};
@@ -35,18 +53,127 @@
  *     int windowSize = 3;
  *     calculateMovingAverage(data, avgData, dataSize, windowSize);
  */
+// 窗口尚未填滿的前段：以原始的求和順序計算，成本 O(min(n, w)^2)
+static void movingAverageRamp(const double* inputData, double* outputData, int dataSize, int windowSize) {
+    int rampEnd = windowSize < dataSize ? windowSize : dataSize;
+    for (int i = 0; i < rampEnd; ++i) {
+        outputData[i] = rampAverage(inputData, i + 1);
+    }
+}
+
 void calculateMovingAverage(const double* inputData, double* outputData, int dataSize, int windowSize) {
     if (inputData == NULL || outputData == NULL || dataSize <= 0 || windowSize <= 0) {
         return; // 錯誤處理：空指針或無效大小
     }
 
-    for (int i = 0; i < dataSize; ++i) {
-        double sum = 0.0;
-        int count = 0;
-        for (int j = i; j >= 0 && count < windowSize; --j, ++count) {
-            sum += inputData[j];
+    // 滑動窗口：每個樣本只加入一次、移出一次；前段只累加，輸出由 movingAverageRamp() 寫入
+    int rampEnd = windowSize < dataSize ? windowSize : dataSize;
+    double sum = 0.0;
+    double compensation = 0.0;
+    for (int i = 0; i < rampEnd; ++i) {
+        neumaierAdd(&sum, &compensation, inputData[i]);
+    }
+    movingAverageRamp(inputData, outputData, dataSize, windowSize);
+    for (int i = rampEnd; i < dataSize; ++i) {
+        neumaierAdd(&sum, &compensation, inputData[i]);
+        neumaierAdd(&sum, &compensation, -inputData[i - windowSize]);
+        outputData[i] = (sum + compensation) / windowSize;
+    }
+}
+
+#if DP_X86_SIMD
+/*
+ * The vector kernels below run one channel per lane and perform exactly the
+ * same IEEE operations, in the same order, as neumaierAdd() and the scalar
+ * loop above. They only accumulate over the ramp-up region, whose outputs are
+ * written per channel by movingAverageRamp(), so every lane is bit-identical to
+ * calculateMovingAverage().
+ */
+__attribute__((target("avx2")))
+static inline __m256d neumaierAddAvx2(__m256d sum, __m256d* compensation, __m256d value) {
+    const __m256d absMask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7fffffffffffffffLL));
+    __m256d t = _mm256_add_pd(sum, value);
+    __m256d sumBig = _mm256_add_pd(_mm256_sub_pd(sum, t), value);
+    __m256d valueBig = _mm256_add_pd(_mm256_sub_pd(value, t), sum);
+    __m256d useSum = _mm256_cmp_pd(_mm256_and_pd(sum, absMask), _mm256_and_pd(value, absMask), _CMP_GE_OQ);
+    *compensation = _mm256_add_pd(*compensation, _mm256_blendv_pd(valueBig, sumBig, useSum));
+    return t;
+}
+
+__attribute__((target("avx2")))
+static void movingAverage4Avx2(const double* const* in, double* const* out, int dataSize, int windowSize) {
+    int rampEnd = windowSize < dataSize ? windowSize : dataSize;
+    __m256d sum = _mm256_setzero_pd();
+    __m256d compensation = _mm256_setzero_pd();
+    double lanes[4];
+    for (int i = 0; i < rampEnd; ++i) {
+        sum = neumaierAddAvx2(sum, &compensation, _mm256_set_pd(in[3][i], in[2][i], in[1][i], in[0][i]));
+    }
+    for (int i = rampEnd; i < dataSize; ++i) {
+        int j = i - windowSize;
+        sum = neumaierAddAvx2(sum, &compensation, _mm256_set_pd(in[3][i], in[2][i], in[1][i], in[0][i]));
+        sum = neumaierAddAvx2(sum, &compensation, _mm256_set_pd(-in[3][j], -in[2][j], -in[1][j], -in[0][j]));
+        _mm256_storeu_pd(lanes, _mm256_div_pd(_mm256_add_pd(sum, compensation), _mm256_set1_pd((double)windowSize)));
+        out[0][i] = lanes[0];
+        out[1][i] = lanes[1];
+        out[2][i] = lanes[2];
+        out[3][i] = lanes[3];
+    }
+}
+
+__attribute__((target("sse2")))
+static inline __m128d neumaierAddSse2(__m128d sum, __m128d* compensation, __m128d value) {
+    const __m128d absMask = _mm_castsi128_pd(_mm_set1_epi64x(0x7fffffffffffffffLL));
+    __m128d t = _mm_add_pd(sum, value);
+    __m128d sumBig = _mm_add_pd(_mm_sub_pd(sum, t), value);
+    __m128d valueBig = _mm_add_pd(_mm_sub_pd(value, t), sum);
+    __m128d useSum = _mm_cmpge_pd(_mm_and_pd(sum, absMask), _mm_and_pd(value, absMask));
+    *compensation = _mm_add_pd(*compensation, _mm_or_pd(_mm_and_pd(useSum, sumBig), _mm_andnot_pd(useSum, valueBig)));
+    return t;
+}
+
+__attribute__((target("sse2")))
+static void movingAverage2Sse2(const double* const* in, double* const* out, int dataSize, int windowSize) {
+    int rampEnd = windowSize < dataSize ? windowSize : dataSize;
+    __m128d sum = _mm_setzero_pd();
+    __m128d compensation = _mm_setzero_pd();
+    double lanes[2];
+    for (int i = 0; i < rampEnd; ++i) {
+        sum = neumaierAddSse2(sum, &compensation, _mm_set_pd(in[1][i], in[0][i]));
+    }
+    for (int i = rampEnd; i < dataSize; ++i) {
+        int j = i - windowSize;
+        sum = neumaierAddSse2(sum, &compensation, _mm_set_pd(in[1][i], in[0][i]));
+        sum = neumaierAddSse2(sum, &compensation, _mm_set_pd(-in[1][j], -in[0][j]));
+        _mm_storeu_pd(lanes, _mm_div_pd(_mm_add_pd(sum, compensation), _mm_set1_pd((double)windowSize)));
+        out[0][i] = lanes[0];
+        out[1][i] = lanes[1];
+    }
+}
+#endif
+
+void calculateMovingAverageMulti(const double* const* inputData, double* const* outputData, int channelCount, int dataSize, int windowSize) {
+    if (inputData == NULL || outputData == NULL || channelCount <= 0 || dataSize <= 0 || windowSize <= 0) {
+        return;
+    }
+
+    int channel = 0;
+#if DP_X86_SIMD
+    if (__builtin_cpu_supports("avx2")) {
+        for (; channel + 4 <= channelCount; channel += 4) {
+            movingAverage4Avx2(inputData + channel, outputData + channel, dataSize, windowSize);
         }
-        outputData[i] = sum / count;
+    }
+    for (; channel + 2 <= channelCount; channel += 2) {
+        movingAverage2Sse2(inputData + channel, outputData + channel, dataSize, windowSize);
+    }
+    for (int c = 0; c < channel; ++c) {
+        movingAverageRamp(inputData[c], outputData[c], dataSize, windowSize);
+    }
+#endif
+    // 剩餘的通道使用標量版本
+    for (; channel < channelCount; ++channel) {
+        calculateMovingAverage(inputData[channel], outputData[channel], dataSize, windowSize);
     }
 }
 
@@ -87,13 +214,11 @@ void butterworthLowPassFilter(const double* inputData, double* outputData, int d
         return; 
     }
 
-    double dt = 1.0 / samplingRate;
-    double RC = 1.0 / (2 * 3.14159265358979323846 * cutoffFrequency);
-    double alpha = dt / (RC + dt);
+    double alpha = butterworthAlpha(cutoffFrequency, samplingRate);
 
     outputData[0] = inputData[0];
     for (int i = 1; i < dataSize; ++i) {
-        outputData[i] = alpha * inputData[i] + (1 - alpha) * outputData[i - 1];
+        outputData[i] = lowPassStep(alpha, inputData[i], outputData[i - 1]);
     }
 }
 
@@ -108,25 +233,17 @@ void detectMovement(const double* inputData, double* outputData, int dataSize, d
     double dt = 1.0 / samplingRate;
     double dtSquared = dt * dt;
 
-    // 初始化输出数组
-    for (int i = 0; i < dataSize; ++i) {
-        outputData[i] = 0.0;
-    }
-
-    // 计算二阶微分（加速度）
+    // 单次遍历：计算二阶微分（加速度）并与阈值比较；保留前一个输入，因此允许原地处理
+    double previous = inputData[0];
+    double current = inputData[1];
+    outputData[0] = movementEdge(threshold); // 端点无法计算二阶微分
     for (int i = 1; i < dataSize - 1; ++i) {
-        double acceleration = (inputData[i+1] - 2 * inputData[i] + inputData[i-1]) / dtSquared;
-        outputData[i] = fabs(acceleration); // 存储绝对值加速度
-    }
-
-    // 标记超过阈值的加速度为运动检测
-    for (int i = 0; i < dataSize; ++i) {
-        if (outputData[i] > threshold) {
-            outputData[i] = 1.0; // 表示检测到运动
-        } else {
-            outputData[i] = 0.0; // 表示未检测到运动
-        }
+        double next = inputData[i + 1];
+        outputData[i] = movementStep(previous, current, next, dtSquared, threshold);
+        previous = current;
+        current = next;
     }
+    outputData[dataSize - 1] = movementEdge(threshold);
 }
 
 
@@ -154,18 +271,83 @@ int applyZupt(double* velocityData, const double* accelData, int dataSize, doubl
 
 //1-Aixs
 void applyLowPassFilter(double* data, int dataSize) {
-    const double alpha = 0.1; // 这个值决定了滤波器的强度，可能需要调整
+    if (data == NULL || dataSize <= 0) {
+        return;
+    }
+
+    const double alpha = APPLY_LOW_PASS_ALPHA; // 这个值决定了滤波器的强度，可能需要调整
     double filteredValue = data[0];
 
     for (int i = 1; i < dataSize; ++i) {
-        filteredValue = alpha * data[i] + (1 - alpha) * filteredValue;
+        filteredValue = lowPassStep(alpha, data[i], filteredValue);
         data[i] = filteredValue;
     }
 }
 
 // bias
 void subtractBias(double* data, int dataSize, double bias) {
+    if (data == NULL) {
+        return;
+    }
     for (int i = 0; i < dataSize; ++i) {
         data[i] -= bias;
     }
 }
+
+// 逐列的 demo.csv 紀錄（每列 11 個值）直接以 stride 視圖交給步態引擎，不複製資料
+void analyzeWalking(const double* inputData, int dataSize, int* stepCount, double* avgStepDistance) {
+    if (stepCount != NULL) {
+        *stepCount = 0;
+    }
+    if (avgStepDistance != NULL) {
+        *avgStepDistance = 0.0;
+    }
+    if (inputData == NULL || dataSize <= 0) {
+        return;
+    }
+
+    ImuRecording recording = {
+        inputData,
+        {inputData + 1, inputData + 2, inputData + 3, inputData + 4},
+        {inputData + 5, inputData + 6, inputData + 7},
+        {inputData + 8, inputData + 9, inputData + 10},
+        dataSize,
+        PEDESTRIAN_RECORD_COLUMNS,
+    };
+    WalkingResult result;
+    if (analyzeWalkingRecording(&recording, NULL, &result, NULL) != 0) {
+        return;
+    }
+    if (stepCount != NULL) {
+        *stepCount = result.stepCount;
+    }
+    if (avgStepDistance != NULL) {
+        *avgStepDistance = result.averageStrideLength;
+    }
+    freeWalkingResult(&result);
+}
+
+static int compareDoubles(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// 以時間戳（秒）相鄰差值的中位數估計採樣率，無法估計時回傳 0
+double estimateSampleRate(const double* timestamps, int count, double* scratch) {
+    if (timestamps == NULL || scratch == NULL || count < 2) {
+        return 0.0;
+    }
+    int deltaCount = 0;
+    for (int i = 1; i < count; i++) {
+        double delta = timestamps[i] - timestamps[i - 1];
+        if (delta > 0) {
+            scratch[deltaCount++] = delta;
+        }
+    }
+    if (deltaCount == 0) {
+        return 0.0;
+    }
+    qsort(scratch, (size_t)deltaCount, sizeof(double), compareDoubles);
+    return 1.0 / scratch[deltaCount / 2];
+}
@@ -26,6 +26,14 @@
  *       The function handles boundary cases by averaging over the available elements
  *       at the start of the input array, which means the first few averages are based on
  *       fewer elements than the specified windowSize.
+ *       The window is maintained as a running sum with Neumaier compensated summation,
+ *       so outputs i >= windowSize cost O(1) each and long recordings do not drift.
+ *       The ramp-up outputs (i < windowSize) are summed newest to oldest like the original
+ *       O(dataSize * windowSize) loop and are bit-identical to it, at a cost of
+ *       O(min(dataSize, windowSize)^2); the total is O(dataSize + min(dataSize, windowSize)^2).
+ *       Later outputs differ from that loop only by rounding (a few ULPs, the compensated
+ *       sum being the more accurate of the two).
+ *       inputData and outputData must not overlap.
  *
  * Example usage:
  *     double data[] = {1.0, 2.0, 3.0, 4.0, 5.0};
@@ -36,6 +44,29 @@
  */
 void calculateMovingAverage(const double* inputData, double* outputData, int dataSize, int windowSize);
 
+/**
+ * Calculates the moving average of several channels (e.g. AX..GZ) at once.
+ *
+ * Each channel is processed exactly like calculateMovingAverage(); on x86 the channels
+ * are packed into SIMD lanes (4 per AVX2 vector when the CPU supports it, otherwise 2
+ * per SSE2 vector) and any remainder falls back to the scalar code. Every lane performs
+ * the same floating-point operations as the scalar version, so the results are
+ * bit-identical to calling calculateMovingAverage() once per channel. The cost per
+ * channel is the same too, including the O(min(dataSize, windowSize)^2) ramp-up.
+ *
+ * @param inputData Array of channelCount pointers to the input arrays.
+ * @param outputData Array of channelCount pointers to the pre-allocated output arrays.
+ * @param channelCount The number of channels to process.
+ * @param dataSize The number of elements in every input and output array.
+ * @param windowSize The size of the moving window, see calculateMovingAverage().
+ *
+ * Example usage:
+ *     const double* in[6] = {ax, ay, az, gx, gy, gz};
+ *     double* out[6] = {axAvg, ayAvg, azAvg, gxAvg, gyAvg, gzAvg};
+ *     calculateMovingAverageMulti(in, out, 6, dataSize, 50);
+ */
+void calculateMovingAverageMulti(const double* const* inputData, double* const* outputData, int channelCount, int dataSize, int windowSize);
+
 
 
 /**
@@ -59,7 +90,8 @@ void calculateMovingAverage(const double* inputData, double* outputData, int dat
  *       This implementation assumes uniform sampling of the input signal and does not
  *       handle initialization conditions, which might be necessary for some applications.
  *       For more complex requirements, a higher-order filter or a different filter design
- *       might be needed.
+ *       might be needed; butterworthDesign() in butterworth_filter.h provides Nth-order
+ *       low/high/band-pass cascades, with this function as the first-order special case.
  *
  * Example usage:
  *     double data[100]; // Some input data
@@ -96,6 +128,8 @@ void butterworthLowPassFilter(const double* inputData, double* outputData, int d
  *       the acceleration using a simple finite difference method and then compares it
  *       against the threshold. The first and last elements of the outputData array are
  *       always set to 0.0 as the second derivative cannot be computed at these points.
+ *       If dataSize is less than 3 the function returns without writing outputData.
+ *       The work is done in a single pass, so inputData and outputData may be the same array.
  *
  * Example usage:
  *     double positionData[100]; // Some position data
@@ -134,8 +168,72 @@ void detectMovement(const double* inputData, double* outputData, int dataSize, d
  */
 int applyZupt(double* velocityData, const double* accelData, int dataSize, double threshold, int continuousCountThreshold);
 
+/**
+ * Smoothing factor used by applyLowPassFilter().
+ */
+#define APPLY_LOW_PASS_ALPHA 0.1
+
+/**
+ * Applies a fixed-strength exponential low-pass filter to a single axis, in place.
+ *
+ * Each sample is replaced by alpha * data[i] + (1 - alpha) * data[i - 1] (filtered),
+ * with alpha = APPLY_LOW_PASS_ALPHA. The first sample is left unchanged.
+ *
+ * @param data Pointer to the array to filter in place.
+ * @param dataSize The number of elements in data. Non-positive sizes are ignored.
+ */
+void applyLowPassFilter(double* data, int dataSize);
+
+/**
+ * Subtracts a constant bias from every element of data, in place.
+ *
+ * @param data Pointer to the array to correct.
+ * @param dataSize The number of elements in data.
+ * @param bias The value subtracted from every sample.
+ */
+void subtractBias(double* data, int dataSize, double bias);
+
+/**
+ * Counts the strides of a foot-mounted IMU walk and their average length.
+ *
+ * inputData holds dataSize row-major records in the demo.csv layout (11 values per row:
+ * timestamp, quaternion w/x/y/z, AX/AY/AZ in g, GX/GY/GZ in deg/s). The records are
+ * processed in a single pass by analyzeWalkingRecording() (pedestrian.h) with default
+ * options: acceleration is rotated into the world frame, integrated with a zero velocity
+ * update at every stance phase, and each swing between two stances counts as a stride.
+ *
+ * @param inputData Pointer to dataSize * 11 values.
+ * @param dataSize The number of records.
+ * @param stepCount Receives the number of strides (0 on error).
+ * @param avgStepDistance Receives the average horizontal stride length in metres
+ *                        (0 on error or without strides).
+ *
+ * Example usage:
+ *     int steps;
+ *     double stride;
+ *     analyzeWalking(records, recordCount, &steps, &stride);
+ */
 void analyzeWalking(const double* inputData, int dataSize, int* stepCount, double* avgStepDistance);
 
+/**
+ * Estimates the sampling rate of a recording from its timestamp column.
+ *
+ * The rate is the reciprocal of the median of the positive differences between
+ * consecutive timestamps, so dropped samples and repeated timestamps do not bias it.
+ *
+ * @param timestamps Pointer to count timestamps in seconds.
+ * @param count The number of timestamps.
+ * @param scratch Pointer to at least count - 1 doubles of working space; overwritten.
+ *
+ * @return The estimated rate in Hz, or 0 if it cannot be estimated (NULL pointers, fewer
+ *         than two timestamps or no increasing pair).
+ *
+ * Example usage:
+ *     double deltas[1463];
+ *     double sampleRate = estimateSampleRate(timestamps, 1464, deltas);
+ */
+double estimateSampleRate(const double* timestamps, int count, double* scratch);
+
 
 
 
@@ -0,0 +1,101 @@
+// data_processing_f32.c
+#include <stddef.h>
+#include <math.h>
+
+#include "data_processing_f32.h"
+#include "data_processing.h"
+#include "dsp_kernels.h"
+
+// 與 rampAverage() 相同的求和順序（由新到舊），輸入先轉成 double
+static double rampAverageF32(const float* data, int count) {
+    double sum = 0.0;
+    for (int j = count - 1; j >= 0; --j) {
+        sum += data[j];
+    }
+    return sum / count;
+}
+
+void calculateMovingAverageF32(const float* inputData, float* outputData, int dataSize, int windowSize) {
+    if (inputData == NULL || outputData == NULL || dataSize <= 0 || windowSize <= 0) {
+        return;
+    }
+
+    // 累加仍使用 double 與補償求和，前段與後段的計算都與 calculateMovingAverage 相同，只在輸出時轉成 float
+    int rampEnd = windowSize < dataSize ? windowSize : dataSize;
+    double sum = 0.0;
+    double compensation = 0.0;
+    for (int i = 0; i < rampEnd; ++i) {
+        neumaierAdd(&sum, &compensation, inputData[i]);
+        outputData[i] = (float)rampAverageF32(inputData, i + 1);
+    }
+    for (int i = rampEnd; i < dataSize; ++i) {
+        neumaierAdd(&sum, &compensation, inputData[i]);
+        neumaierAdd(&sum, &compensation, -(double)inputData[i - windowSize]);
+        outputData[i] = (float)((sum + compensation) / windowSize);
+    }
+}
+
+static void lowPassF32(const float* inputData, float* outputData, int dataSize, float alpha) {
+    const float beta = 1.0f - alpha;
+    float filtered = inputData[0];
+    outputData[0] = filtered;
+    for (int i = 1; i < dataSize; ++i) {
+        filtered = alpha * inputData[i] + beta * filtered;
+        outputData[i] = filtered;
+    }
+}
+
+void butterworthLowPassFilterF32(const float* inputData, float* outputData, int dataSize, double cutoffFrequency, double samplingRate) {
+    if (inputData == NULL || outputData == NULL || dataSize <= 0 || cutoffFrequency <= 0 || samplingRate <= 0) {
+        return;
+    }
+    lowPassF32(inputData, outputData, dataSize, (float)butterworthAlpha(cutoffFrequency, samplingRate));
+}
+
+void detectMovementF32(const float* inputData, float* outputData, int dataSize, double threshold, double samplingRate) {
+    if (inputData == NULL || outputData == NULL || dataSize < 3 || samplingRate <= 0) {
+        return;
+    }
+
+    // 以 threshold * dt^2 比較二階差分，避免每個樣本做除法
+    double dt = 1.0 / samplingRate;
+    const float limit = (float)(threshold * dt * dt);
+    const float edge = (float)movementEdge(threshold);
+
+    if (inputData != outputData) {
+        // 無相依性的迴圈，編譯器可向量化
+        for (int i = 1; i < dataSize - 1; ++i) {
+            float difference = inputData[i + 1] - 2.0f * inputData[i] + inputData[i - 1];
+            outputData[i] = fabsf(difference) > limit ? 1.0f : 0.0f;
+        }
+    } else {
+        float previous = inputData[0];
+        float current = inputData[1];
+        for (int i = 1; i < dataSize - 1; ++i) {
+            float next = inputData[i + 1];
+            float difference = next - 2.0f * current + previous;
+            outputData[i] = fabsf(difference) > limit ? 1.0f : 0.0f;
+            previous = current;
+            current = next;
+        }
+    }
+    outputData[0] = edge;
+    outputData[dataSize - 1] = edge;
+}
+
+void applyLowPassFilterF32(float* data, int dataSize) {
+    if (data == NULL || dataSize <= 0) {
+        return;
+    }
+    lowPassF32(data, data, dataSize, (float)APPLY_LOW_PASS_ALPHA);
+}
+
+void subtractBiasF32(float* data, int dataSize, double bias) {
+    if (data == NULL) {
+        return;
+    }
+    const float biasF32 = (float)bias;
+    for (int i = 0; i < dataSize; ++i) {
+        data[i] -= biasF32;
+    }
+}
@@ -0,0 +1,93 @@
+// data_processing_f32.h
+
+#ifndef DATA_PROCESSING_F32_H
+#define DATA_PROCESSING_F32_H
+
+/*
+ * Single-precision variants of the data_processing.h kernels.
+ *
+ * Each function takes and produces float arrays, halving memory traffic and doubling
+ * the SIMD width compared to the double versions. The accuracy bounds below are stated
+ * against the double function applied to the same float input widened to double
+ * ("the reference"); eps = 2^-24 is the float unit roundoff.
+ */
+
+/**
+ * Single-precision calculateMovingAverage().
+ *
+ * The running window sum is kept in double with the same compensated summation as the
+ * reference, and the ramp-up outputs (i < windowSize) are summed newest to oldest in
+ * double like the reference's, at the same O(min(dataSize, windowSize)^2) cost, so the
+ * only difference is the final rounding of each average to float.
+ *
+ * @param inputData Pointer to the input samples.
+ * @param outputData Pointer to the pre-allocated output array, same size as inputData.
+ * @param dataSize The number of elements in inputData and outputData.
+ * @param windowSize The size of the moving window.
+ *
+ * @note Accuracy: every output is the reference value correctly rounded to float,
+ *       i.e. |error| <= eps * |reference|. inputData and outputData must not overlap.
+ *
+ * Example usage:
+ *     float data[] = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f};
+ *     float avgData[5];
+ *     calculateMovingAverageF32(data, avgData, 5, 3);
+ */
+void calculateMovingAverageF32(const float* inputData, float* outputData, int dataSize, int windowSize);
+
+/**
+ * Single-precision butterworthLowPassFilter().
+ *
+ * The coefficient is computed in double and rounded once to float; the recursion runs
+ * entirely in float.
+ *
+ * @param inputData Pointer to the input samples.
+ * @param outputData Pointer to the pre-allocated output array, may equal inputData.
+ * @param dataSize The number of elements in inputData and outputData.
+ * @param cutoffFrequency The cutoff frequency in Hz.
+ * @param samplingRate The sampling rate in Hz.
+ *
+ * @note Accuracy: each step adds at most about 3 * eps * max|x| of rounding error, which the
+ *       filter forgets at rate (1 - alpha), so |error| <= 4 * eps * max|x| / alpha, where
+ *       alpha = 2*pi*fc / (2*pi*fc + fs). For fc = 5 Hz at 1 kHz this is about 8e-6 * max|x|.
+ *
+ * Example usage:
+ *     butterworthLowPassFilterF32(data, filteredData, dataSize, 5.0, 1000.0);
+ */
+void butterworthLowPassFilterF32(const float* inputData, float* outputData, int dataSize, double cutoffFrequency, double samplingRate);
+
+/**
+ * Single-precision detectMovement().
+ *
+ * @param inputData Pointer to the input samples.
+ * @param outputData Pointer to the output array; receives 1.0f where movement is detected,
+ *                   0.0f elsewhere. May equal inputData.
+ * @param dataSize The number of elements in inputData and outputData.
+ * @param threshold The acceleration threshold, as in detectMovement().
+ * @param samplingRate The sampling rate in Hz.
+ *
+ * @note Accuracy: the second difference is computed in float and can differ from the
+ *       reference by 4 * eps * (|x[i-1]| + 2|x[i]| + |x[i+1]|) * fs^2 and the threshold is
+ *       rounded to float, so a flag can only differ from the reference for samples whose
+ *       acceleration lies within that distance plus 2 * eps * threshold of threshold. Out-of-place calls use a branch-free loop the compiler vectorizes;
+ *       in-place calls fall back to the single-pass loop of detectMovement().
+ */
+void detectMovementF32(const float* inputData, float* outputData, int dataSize, double threshold, double samplingRate);
+
+/**
+ * Single-precision applyLowPassFilter() (alpha = APPLY_LOW_PASS_ALPHA), in place.
+ *
+ * @note Accuracy: |error| <= 40 * eps * max|x|, the bound of butterworthLowPassFilterF32()
+ *       with alpha = 0.1.
+ */
+void applyLowPassFilterF32(float* data, int dataSize);
+
+/**
+ * Single-precision subtractBias(), in place.
+ *
+ * @note Accuracy: the bias is rounded to float once, so
+ *       |error| <= eps * (|data[i] - bias| + |bias|).
+ */
+void subtractBiasF32(float* data, int dataSize, double bias);
+
+#endif // DATA_PROCESSING_F32_H
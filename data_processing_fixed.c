@@ -0,0 +1,265 @@
+// data_processing_fixed.c
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "data_processing_fixed.h"
+#include "data_processing.h"
+#include "dsp_kernels.h"
+
+#define Q15_ONE 32768.0
+#define Q31_ONE 2147483648.0
+
+static int64_t saturate(int64_t value, int64_t low, int64_t high) {
+    return value < low ? low : (value > high ? high : value);
+}
+
+static int64_t quantize(double value, double scale, int64_t low, int64_t high) {
+    double scaled = value * scale;
+    if (!(scaled > (double)low)) {
+        return low; // 也處理 NaN
+    }
+    if (scaled >= (double)high) {
+        return high;
+    }
+    return saturate(llround(scaled), low, high);
+}
+
+void convertToQ15(const double* inputData, int16_t* outputData, int dataSize, double fullScale) {
+    if (inputData == NULL || outputData == NULL || fullScale <= 0) {
+        return;
+    }
+    const double scale = Q15_ONE / fullScale;
+    for (int i = 0; i < dataSize; ++i) {
+        outputData[i] = (int16_t)quantize(inputData[i], scale, INT16_MIN, INT16_MAX);
+    }
+}
+
+void convertToQ31(const double* inputData, int32_t* outputData, int dataSize, double fullScale) {
+    if (inputData == NULL || outputData == NULL || fullScale <= 0) {
+        return;
+    }
+    const double scale = Q31_ONE / fullScale;
+    for (int i = 0; i < dataSize; ++i) {
+        outputData[i] = (int32_t)quantize(inputData[i], scale, INT32_MIN, INT32_MAX);
+    }
+}
+
+void convertFromQ15(const int16_t* inputData, double* outputData, int dataSize, double fullScale) {
+    if (inputData == NULL || outputData == NULL) {
+        return;
+    }
+    const double scale = fullScale / Q15_ONE;
+    for (int i = 0; i < dataSize; ++i) {
+        outputData[i] = inputData[i] * scale;
+    }
+}
+
+void convertFromQ31(const int32_t* inputData, double* outputData, int dataSize, double fullScale) {
+    if (inputData == NULL || outputData == NULL) {
+        return;
+    }
+    const double scale = fullScale / Q31_ONE;
+    for (int i = 0; i < dataSize; ++i) {
+        outputData[i] = inputData[i] * scale;
+    }
+}
+
+void calculateMovingAverageQ15(const int16_t* inputData, int16_t* outputData, int dataSize, int windowSize) {
+    if (inputData == NULL || outputData == NULL || dataSize <= 0 || windowSize <= 0) {
+        return;
+    }
+
+    int64_t sum = 0;
+    for (int i = 0; i < dataSize; ++i) {
+        sum += inputData[i];
+        int count = i + 1;
+        if (i >= windowSize) {
+            sum -= inputData[i - windowSize];
+            count = windowSize;
+        }
+        // |sum| < 2^47 可精確表示為 double；商與 .5 的距離至少 1/(2*count)，
+        // 遠大於 double 的捨入誤差，因此 llround 的結果等於精確的四捨五入
+        outputData[i] = (int16_t)llround((double)sum / count);
+    }
+}
+
+// 四捨五入（遠離零）的整數除法
+static int64_t divideRounded(int64_t numerator, int64_t denominator) {
+    int64_t half = denominator / 2;
+    return (numerator >= 0 ? numerator + half : numerator - half) / denominator;
+}
+
+void calculateMovingAverageQ31(const int32_t* inputData, int32_t* outputData, int dataSize, int windowSize) {
+    if (inputData == NULL || outputData == NULL || dataSize <= 0 || windowSize <= 0) {
+        return;
+    }
+
+    int64_t sum = 0;
+    for (int i = 0; i < dataSize; ++i) {
+        sum += inputData[i];
+        int count = i + 1;
+        if (i >= windowSize) {
+            sum -= inputData[i - windowSize];
+            count = windowSize;
+        }
+        outputData[i] = (int32_t)divideRounded(sum, count);
+    }
+}
+
+// alpha 以 Q31 表示，限制在 (0, 1) 內，使 alpha * (x - y) 不會超出 64 位元
+static int64_t alphaToQ31(double alpha) {
+    return saturate(llround(alpha * Q31_ONE), 1, INT32_MAX);
+}
+
+// Q31 狀態上的一階低通：y += alpha * (x - y)，乘積四捨五入
+static inline int64_t lowPassStepQ31(int64_t alpha, int64_t input, int64_t state) {
+    return state + ((alpha * (input - state) + (INT64_C(1) << 30)) >> 31);
+}
+
+static void lowPassQ15(const int16_t* inputData, int16_t* outputData, int dataSize, int64_t alpha) {
+    int64_t state = (int64_t)inputData[0] * 65536;
+    outputData[0] = inputData[0];
+    for (int i = 1; i < dataSize; ++i) {
+        state = lowPassStepQ31(alpha, (int64_t)inputData[i] * 65536, state);
+        outputData[i] = (int16_t)saturate((state + 32768) >> 16, INT16_MIN, INT16_MAX);
+    }
+}
+
+static void lowPassQ31(const int32_t* inputData, int32_t* outputData, int dataSize, int64_t alpha) {
+    int64_t state = inputData[0];
+    outputData[0] = inputData[0];
+    for (int i = 1; i < dataSize; ++i) {
+        state = lowPassStepQ31(alpha, inputData[i], state);
+        outputData[i] = (int32_t)saturate(state, INT32_MIN, INT32_MAX);
+    }
+}
+
+void butterworthLowPassFilterQ15(const int16_t* inputData, int16_t* outputData, int dataSize, double cutoffFrequency, double samplingRate) {
+    if (inputData == NULL || outputData == NULL || dataSize <= 0 || cutoffFrequency <= 0 || samplingRate <= 0) {
+        return;
+    }
+    lowPassQ15(inputData, outputData, dataSize, alphaToQ31(butterworthAlpha(cutoffFrequency, samplingRate)));
+}
+
+void butterworthLowPassFilterQ31(const int32_t* inputData, int32_t* outputData, int dataSize, double cutoffFrequency, double samplingRate) {
+    if (inputData == NULL || outputData == NULL || dataSize <= 0 || cutoffFrequency <= 0 || samplingRate <= 0) {
+        return;
+    }
+    lowPassQ31(inputData, outputData, dataSize, alphaToQ31(butterworthAlpha(cutoffFrequency, samplingRate)));
+}
+
+void applyLowPassFilterQ15(int16_t* data, int dataSize) {
+    if (data == NULL || dataSize <= 0) {
+        return;
+    }
+    lowPassQ15(data, data, dataSize, alphaToQ31(APPLY_LOW_PASS_ALPHA));
+}
+
+void applyLowPassFilterQ31(int32_t* data, int dataSize) {
+    if (data == NULL || dataSize <= 0) {
+        return;
+    }
+    lowPassQ31(data, data, dataSize, alphaToQ31(APPLY_LOW_PASS_ALPHA));
+}
+
+/*
+ * Integer limit for the second difference: for integer d, |d| / one / dt^2 > threshold
+ * is equivalent to |d| > floor(threshold * dt^2 * one). A negative threshold flags every
+ * sample, which a limit of -1 reproduces.
+ */
+static int64_t movementLimit(double threshold, double samplingRate, double one) {
+    double dt = 1.0 / samplingRate;
+    double limit = floor(threshold * dt * dt * one);
+    if (limit < 0) {
+        return -1;
+    }
+    return limit >= 0x1p62 ? INT64_C(1) << 62 : (int64_t)limit;
+}
+
+void detectMovementQ15(const int16_t* inputData, int16_t* outputData, int dataSize, double threshold, double samplingRate) {
+    if (inputData == NULL || outputData == NULL || dataSize < 3 || samplingRate <= 0) {
+        return;
+    }
+
+    // 二階差分最多 2^17，限制在 int32 範圍內即可
+    const int32_t limit = (int32_t)saturate(movementLimit(threshold, samplingRate, Q15_ONE), -1, INT32_MAX);
+    const int16_t edge = (int16_t)movementEdge(threshold);
+
+    if (inputData != outputData) {
+        for (int i = 1; i < dataSize - 1; ++i) {
+            int32_t difference = (int32_t)inputData[i + 1] - 2 * (int32_t)inputData[i] + (int32_t)inputData[i - 1];
+            outputData[i] = (int16_t)(abs(difference) > limit);
+        }
+    } else {
+        int32_t previous = inputData[0];
+        int32_t current = inputData[1];
+        for (int i = 1; i < dataSize - 1; ++i) {
+            int32_t next = inputData[i + 1];
+            int32_t difference = next - 2 * current + previous;
+            outputData[i] = (int16_t)(abs(difference) > limit);
+            previous = current;
+            current = next;
+        }
+    }
+    outputData[0] = edge;
+    outputData[dataSize - 1] = edge;
+}
+
+void detectMovementQ31(const int32_t* inputData, int32_t* outputData, int dataSize, double threshold, double samplingRate) {
+    if (inputData == NULL || outputData == NULL || dataSize < 3 || samplingRate <= 0) {
+        return;
+    }
+
+    const int64_t limit = movementLimit(threshold, samplingRate, Q31_ONE);
+    const int32_t edge = (int32_t)movementEdge(threshold);
+
+    if (inputData != outputData) {
+        for (int i = 1; i < dataSize - 1; ++i) {
+            int64_t difference = (int64_t)inputData[i + 1] - 2 * (int64_t)inputData[i] + (int64_t)inputData[i - 1];
+            outputData[i] = (int32_t)((difference < 0 ? -difference : difference) > limit);
+        }
+    } else {
+        int64_t previous = inputData[0];
+        int64_t current = inputData[1];
+        for (int i = 1; i < dataSize - 1; ++i) {
+            int64_t next = inputData[i + 1];
+            int64_t difference = next - 2 * current + previous;
+            outputData[i] = (int32_t)((difference < 0 ? -difference : difference) > limit);
+            previous = current;
+            current = next;
+        }
+    }
+    outputData[0] = edge;
+    outputData[dataSize - 1] = edge;
+}
+
+/*
+ * Saturating subtraction written in the lane width of the data (wrap, then detect
+ * overflow from the sign bits) so the compiler vectorizes it with 8 / 4 lanes per SSE
+ * register instead of widening every sample.
+ */
+void subtractBiasQ15(int16_t* data, int dataSize, int16_t bias) {
+    if (data == NULL) {
+        return;
+    }
+    for (int i = 0; i < dataSize; ++i) {
+        int16_t value = data[i];
+        int16_t difference = (int16_t)(uint16_t)((uint16_t)value - (uint16_t)bias);
+        int16_t overflow = (int16_t)((value ^ bias) & (value ^ difference));
+        data[i] = overflow < 0 ? (value < 0 ? INT16_MIN : INT16_MAX) : difference;
+    }
+}
+
+void subtractBiasQ31(int32_t* data, int dataSize, int32_t bias) {
+    if (data == NULL) {
+        return;
+    }
+    for (int i = 0; i < dataSize; ++i) {
+        int32_t value = data[i];
+        int32_t difference = (int32_t)((uint32_t)value - (uint32_t)bias);
+        int32_t overflow = (value ^ bias) & (value ^ difference);
+        data[i] = overflow < 0 ? (value < 0 ? INT32_MIN : INT32_MAX) : difference;
+    }
+}
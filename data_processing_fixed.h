@@ -0,0 +1,105 @@
+// data_processing_fixed.h
+
+#ifndef DATA_PROCESSING_FIXED_H
+#define DATA_PROCESSING_FIXED_H
+
+#include <stdint.h>
+
+/*
+ * Fixed-point (Q15 and Q31) variants of the data_processing.h kernels.
+ *
+ * A Q15 sample q represents q / 2^15 and a Q31 sample q / 2^31, i.e. fractions of the
+ * sensor full scale in [-1, 1). 16-bit sensor counts can be used as Q15 directly. The
+ * convert* helpers map physical values to and from Q format for a given full scale.
+ *
+ * Accuracy bounds are stated in output LSBs against the double function applied to the
+ * same samples converted to double ("the reference"). Thresholds, cutoffs and biases
+ * are expressed in the same fractional units as the samples.
+ */
+
+/**
+ * Converts physical values to Q15 / Q31 fractions of fullScale, rounding to nearest and
+ * saturating values outside [-fullScale, fullScale).
+ *
+ * Example usage:
+ *     int16_t ax[100];
+ *     convertToQ15(axInG, ax, 100, 16.0); // +-16 g accelerometer
+ */
+void convertToQ15(const double* inputData, int16_t* outputData, int dataSize, double fullScale);
+void convertToQ31(const double* inputData, int32_t* outputData, int dataSize, double fullScale);
+
+/**
+ * Converts Q15 / Q31 fractions back to physical values (exact for Q15).
+ */
+void convertFromQ15(const int16_t* inputData, double* outputData, int dataSize, double fullScale);
+void convertFromQ31(const int32_t* inputData, double* outputData, int dataSize, double fullScale);
+
+/**
+ * Fixed-point calculateMovingAverage().
+ *
+ * The window sum is kept exactly in a 64-bit accumulator, so there is no drift at all;
+ * each output is the exact window mean rounded to nearest (ties away from zero).
+ *
+ * @param inputData Pointer to the input samples.
+ * @param outputData Pointer to the pre-allocated output array; must not overlap inputData.
+ * @param dataSize The number of elements in inputData and outputData.
+ * @param windowSize The size of the moving window (at most 2^32 for Q31).
+ *
+ * @note Accuracy: |error| <= 0.5 LSB.
+ */
+void calculateMovingAverageQ15(const int16_t* inputData, int16_t* outputData, int dataSize, int windowSize);
+void calculateMovingAverageQ31(const int32_t* inputData, int32_t* outputData, int dataSize, int windowSize);
+
+/**
+ * Fixed-point butterworthLowPassFilter().
+ *
+ * The recursion y += alpha * (x - y) runs on a Q31 state with a Q31 coefficient (Q15
+ * inputs get 16 guard bits), so small steps are not lost to truncation.
+ *
+ * @param inputData Pointer to the input samples.
+ * @param outputData Pointer to the pre-allocated output array, may equal inputData.
+ * @param dataSize The number of elements in inputData and outputData.
+ * @param cutoffFrequency The cutoff frequency in Hz.
+ * @param samplingRate The sampling rate in Hz.
+ *
+ * @note Accuracy: each step rounds the state by at most 0.5 Q31 LSB, which the filter
+ *       forgets at rate (1 - alpha), so the state error is at most 0.5 / alpha Q31 LSB.
+ *       Q15 output: |error| <= 0.5 + 2^-17 / alpha LSB (below 1 LSB for alpha >= 2^-16).
+ *       Q31 output: |error| <= 0.5 / alpha LSB (about 16 LSB for fc = 5 Hz at 1 kHz).
+ *       Quantizing alpha to Q31 changes the cutoff by a relative 2^-32 / alpha at most.
+ */
+void butterworthLowPassFilterQ15(const int16_t* inputData, int16_t* outputData, int dataSize, double cutoffFrequency, double samplingRate);
+void butterworthLowPassFilterQ31(const int32_t* inputData, int32_t* outputData, int dataSize, double cutoffFrequency, double samplingRate);
+
+/**
+ * Fixed-point applyLowPassFilter() (alpha = APPLY_LOW_PASS_ALPHA), in place.
+ *
+ * @note Accuracy: Q15 within 0.5 LSB (plus 2^-17 / 0.1), Q31 within 5 LSB.
+ */
+void applyLowPassFilterQ15(int16_t* data, int dataSize);
+void applyLowPassFilterQ31(int32_t* data, int dataSize);
+
+/**
+ * Fixed-point detectMovement().
+ *
+ * outputData receives 1 where movement is detected and 0 elsewhere (integer flags, not
+ * Q values). The second difference is computed exactly in integers and compared with an
+ * integer limit derived from threshold, so the flags are exact: they differ from the
+ * reference only where the reference's own rounding of the acceleration crosses the
+ * threshold (within a few double ulps of it). Out-of-place calls use a vectorizable loop;
+ * inputData and outputData may be the same array.
+ *
+ * @param threshold The acceleration threshold in full-scale fractions per s^2.
+ */
+void detectMovementQ15(const int16_t* inputData, int16_t* outputData, int dataSize, double threshold, double samplingRate);
+void detectMovementQ31(const int32_t* inputData, int32_t* outputData, int dataSize, double threshold, double samplingRate);
+
+/**
+ * Fixed-point subtractBias(), in place, saturating at the ends of the Q range.
+ *
+ * @note Accuracy: exact unless the result saturates.
+ */
+void subtractBiasQ15(int16_t* data, int dataSize, int16_t bias);
+void subtractBiasQ31(int32_t* data, int dataSize, int32_t bias);
+
+#endif // DATA_PROCESSING_FIXED_H
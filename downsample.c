@@ -0,0 +1,234 @@
+// downsample.c
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "downsample.h"
+
+int downsampleCount(DownsampleMode mode, int dataSize, int targetPoints) {
+    if (dataSize <= targetPoints) {
+        return dataSize > 0 ? dataSize : 0;
+    }
+    return mode == DOWNSAMPLE_MIN_MAX ? targetPoints / 2 * 2 : targetPoints;
+}
+
+static int passesThrough(const Downsampler* downsampler) {
+    return downsampler->dataSize <= downsampler->targetPoints;
+}
+
+static void emitPoint(Downsampler* downsampler, double x, double y) {
+    downsampler->points[2 * downsampler->count] = x;
+    downsampler->points[2 * downsampler->count + 1] = y;
+    downsampler->count++;
+}
+
+// min/max 的第 bucket 個桶結束於此（不含）
+static int minMaxBoundary(const Downsampler* downsampler, int bucket) {
+    int bucketCount = downsampler->targetPoints / 2;
+    return (int)((long long)(bucket + 1) * downsampler->dataSize / bucketCount);
+}
+
+// LTTB 的第 bucket 個桶結束於此；中間 dataSize - 2 個樣本分成 targetPoints - 2 個桶
+static int lttbBoundary(const Downsampler* downsampler, int bucket) {
+    if (bucket >= downsampler->targetPoints - 3) {
+        return downsampler->dataSize - 1;
+    }
+    return (int)floor((bucket + 1) * downsampler->bucketWidth) + 1;
+}
+
+int downsamplerInit(Downsampler* downsampler, DownsampleMode mode, int dataSize, int targetPoints, double* points, DspContext* context) {
+    int minimumPoints = mode == DOWNSAMPLE_LTTB ? 3 : 2;
+    if (downsampler == NULL || points == NULL || dataSize < 0 || targetPoints < minimumPoints
+        || (mode != DOWNSAMPLE_MIN_MAX && mode != DOWNSAMPLE_LTTB)) {
+        return -1;
+    }
+    memset(downsampler, 0, sizeof(*downsampler));
+    downsampler->mode = mode;
+    downsampler->dataSize = dataSize;
+    downsampler->targetPoints = targetPoints;
+    downsampler->points = points;
+    downsampler->context = context;
+    downsampler->minIndex = -1;
+    downsampler->maxIndex = -1;
+    if (passesThrough(downsampler)) {
+        return 0;
+    }
+
+    if (mode == DOWNSAMPLE_MIN_MAX) {
+        downsampler->bucketEnd = minMaxBoundary(downsampler, 0);
+        return 0;
+    }
+    downsampler->bucketWidth = (double)(dataSize - 2) / (targetPoints - 2);
+    downsampler->bucketEnd = lttbBoundary(downsampler, 0);
+    downsampler->fillingStart = 1;
+    size_t bucketCapacity = (size_t)ceil(downsampler->bucketWidth) + 1;
+    downsampler->buffer = context != NULL
+        ? dspContextAllocDoubles(context, 2 * bucketCapacity)
+        : malloc(sizeof(double) * 2 * bucketCapacity);
+    if (downsampler->buffer == NULL) {
+        return -1;
+    }
+    downsampler->pending = downsampler->buffer;
+    downsampler->filling = downsampler->buffer + bucketCapacity;
+    return 0;
+}
+
+static void pushMinMax(Downsampler* downsampler, const double* data, int count) {
+    while (count > 0) {
+        int take = downsampler->bucketEnd - downsampler->position;
+        if (take > count) {
+            take = count;
+        }
+        for (int k = 0; k < take; ++k) {
+            double value = data[k];
+            if (downsampler->minIndex < 0 || value < downsampler->minValue) {
+                downsampler->minValue = value;
+                downsampler->minIndex = downsampler->position + k;
+            }
+            if (downsampler->maxIndex < 0 || value > downsampler->maxValue) {
+                downsampler->maxValue = value;
+                downsampler->maxIndex = downsampler->position + k;
+            }
+        }
+        downsampler->position += take;
+        data += take;
+        count -= take;
+
+        if (downsampler->position == downsampler->bucketEnd) {
+            // 依樣本順序輸出，折線才不會往回畫
+            if (downsampler->minIndex <= downsampler->maxIndex) {
+                emitPoint(downsampler, downsampler->minIndex, downsampler->minValue);
+                emitPoint(downsampler, downsampler->maxIndex, downsampler->maxValue);
+            } else {
+                emitPoint(downsampler, downsampler->maxIndex, downsampler->maxValue);
+                emitPoint(downsampler, downsampler->minIndex, downsampler->minValue);
+            }
+            downsampler->minIndex = -1;
+            downsampler->maxIndex = -1;
+            downsampler->bucket++;
+            downsampler->bucketEnd = minMaxBoundary(downsampler, downsampler->bucket);
+        }
+    }
+}
+
+// 從 pending 桶選出與上一個保留點及 (nextX, nextY) 構成最大三角形的樣本
+static void selectPending(Downsampler* downsampler, double nextX, double nextY) {
+    double ax = downsampler->selectedX;
+    double ay = downsampler->selectedY;
+    double bestArea = -1.0;
+    int best = 0;
+    for (int k = 0; k < downsampler->pendingCount; ++k) {
+        double x = downsampler->pendingStart + k;
+        double area = fabs((ax - nextX) * (downsampler->pending[k] - ay) - (ax - x) * (nextY - ay));
+        if (area > bestArea) {
+            bestArea = area;
+            best = k;
+        }
+    }
+    downsampler->selectedX = downsampler->pendingStart + best;
+    downsampler->selectedY = downsampler->pending[best];
+    emitPoint(downsampler, downsampler->selectedX, downsampler->selectedY);
+}
+
+static void pushLttb(Downsampler* downsampler, const double* data, int count) {
+    for (int k = 0; k < count; ++k) {
+        int index = downsampler->position++;
+        double value = data[k];
+        if (index == 0) {
+            downsampler->selectedX = 0.0;
+            downsampler->selectedY = value;
+            emitPoint(downsampler, 0.0, value);
+            continue;
+        }
+        if (index == downsampler->dataSize - 1) {
+            downsampler->lastValue = value;
+            continue;
+        }
+        downsampler->filling[downsampler->fillingCount++] = value;
+        downsampler->fillingSum += value;
+        if (downsampler->position < downsampler->bucketEnd) {
+            continue;
+        }
+
+        // 填滿一個桶：前一個桶現在知道下一桶的平均值，可以選點
+        if (downsampler->bucket > 0) {
+            selectPending(downsampler, downsampler->fillingStart + (downsampler->fillingCount - 1) * 0.5,
+                          downsampler->fillingSum / downsampler->fillingCount);
+        }
+        double* swap = downsampler->pending;
+        downsampler->pending = downsampler->filling;
+        downsampler->filling = swap;
+        downsampler->pendingStart = downsampler->fillingStart;
+        downsampler->pendingCount = downsampler->fillingCount;
+        downsampler->fillingStart = downsampler->bucketEnd;
+        downsampler->fillingCount = 0;
+        downsampler->fillingSum = 0.0;
+        downsampler->bucket++;
+        downsampler->bucketEnd = lttbBoundary(downsampler, downsampler->bucket);
+    }
+}
+
+void downsamplerPush(Downsampler* downsampler, const double* data, int count) {
+    if (downsampler == NULL || data == NULL || count <= 0) {
+        return;
+    }
+    if (count > downsampler->dataSize - downsampler->position) {
+        count = downsampler->dataSize - downsampler->position;
+    }
+    if (passesThrough(downsampler)) {
+        for (int k = 0; k < count; ++k) {
+            emitPoint(downsampler, downsampler->position + k, data[k]);
+        }
+        downsampler->position += count;
+    } else if (downsampler->mode == DOWNSAMPLE_MIN_MAX) {
+        pushMinMax(downsampler, data, count);
+    } else {
+        pushLttb(downsampler, data, count);
+    }
+}
+
+int downsamplerFinish(Downsampler* downsampler) {
+    if (downsampler == NULL || downsampler->position < downsampler->dataSize) {
+        return -1;
+    }
+    if (!passesThrough(downsampler) && downsampler->mode == DOWNSAMPLE_LTTB
+        && downsampler->count < downsampler->targetPoints) {
+        // 最後一個桶以最後一個樣本作為下一點
+        selectPending(downsampler, downsampler->dataSize - 1, downsampler->lastValue);
+        emitPoint(downsampler, downsampler->dataSize - 1, downsampler->lastValue);
+    }
+    return downsampler->count;
+}
+
+void downsamplerFree(Downsampler* downsampler) {
+    if (downsampler == NULL) {
+        return;
+    }
+    if (downsampler->context == NULL) {
+        free(downsampler->buffer);
+    }
+    downsampler->buffer = NULL;
+    downsampler->pending = NULL;
+    downsampler->filling = NULL;
+}
+
+int downsample(DownsampleMode mode, const double* data, int dataSize, int targetPoints, double* points, DspContext* context) {
+    if (data == NULL && dataSize > 0) {
+        return -1;
+    }
+    DspContextMark mark;
+    if (context != NULL) {
+        mark = dspContextMark(context);
+    }
+    Downsampler downsampler;
+    if (downsamplerInit(&downsampler, mode, dataSize, targetPoints, points, context) != 0) {
+        return -1;
+    }
+    downsamplerPush(&downsampler, data, dataSize);
+    int count = downsamplerFinish(&downsampler);
+    downsamplerFree(&downsampler);
+    if (context != NULL) {
+        dspContextRelease(context, &mark);
+    }
+    return count;
+}
@@ -0,0 +1,106 @@
+// downsample.h
+
+#ifndef DOWNSAMPLE_H
+#define DOWNSAMPLE_H
+
+#include "dsp_context.h"
+
+/*
+ * Plot-aware decimation: reduces a signal to a fixed number of points before plotting.
+ *
+ * A plot is at most a few thousand pixels wide, so sending millions of samples to gnuplot
+ * only costs time and memory. Both modes keep the shape that matters on screen:
+ *
+ *   DOWNSAMPLE_MIN_MAX  splits the signal into targetPoints / 2 equal buckets and keeps
+ *                       the minimum and the maximum of each (in sample order), so the
+ *                       envelope and every spike survive exactly.
+ *   DOWNSAMPLE_LTTB     Largest-Triangle-Three-Buckets: keeps the first and last sample
+ *                       and, from each of targetPoints - 2 buckets, the sample forming
+ *                       the largest triangle with the point kept before it and the mean
+ *                       of the next bucket, which preserves the visual trend.
+ *
+ * The decimator is streaming: samples are pushed in blocks of any size (e.g. the blocks
+ * a Pipeline produces) and each is touched once. Min/max keeps O(1) state; LTTB buffers
+ * two buckets. Points are written as interleaved (sample index, value) pairs, so the
+ * x coordinate is the original sample position.
+ */
+
+typedef enum {
+    DOWNSAMPLE_MIN_MAX,
+    DOWNSAMPLE_LTTB
+} DownsampleMode;
+
+typedef struct {
+    DownsampleMode mode;
+    int dataSize;
+    int targetPoints;
+    double* points;           // output: count (x, y) pairs
+    int count;
+    int position;             // samples pushed so far
+    int bucket;               // bucket being filled
+    int bucketEnd;            // first sample after it
+    double bucketWidth;
+    // DOWNSAMPLE_MIN_MAX
+    double minValue;
+    double maxValue;
+    int minIndex;
+    int maxIndex;
+    // DOWNSAMPLE_LTTB：等待選點的前一個桶與正在填入的桶
+    double* pending;
+    int pendingStart;
+    int pendingCount;
+    double* filling;
+    int fillingStart;
+    int fillingCount;
+    double fillingSum;
+    double selectedX;         // last point kept
+    double selectedY;
+    double lastValue;         // sample dataSize - 1, always kept
+    double* buffer;           // storage of pending and filling
+    DspContext* context;      // owner of buffer, NULL for the heap
+} Downsampler;
+
+/**
+ * Returns the number of points downsample() produces for dataSize samples: dataSize if it
+ * does not exceed targetPoints (the signal is passed through), otherwise targetPoints
+ * rounded down to even for DOWNSAMPLE_MIN_MAX and targetPoints for DOWNSAMPLE_LTTB.
+ */
+int downsampleCount(DownsampleMode mode, int dataSize, int targetPoints);
+
+/**
+ * Prepares to decimate dataSize samples.
+ *
+ * @param targetPoints At least 2 for DOWNSAMPLE_MIN_MAX, at least 3 for DOWNSAMPLE_LTTB.
+ * @param points Receives 2 * downsampleCount() doubles.
+ * @param context Arena for the LTTB bucket buffers, or NULL to use the heap.
+ * @return 0 on success, -1 on invalid arguments or allocation failure.
+ */
+int downsamplerInit(Downsampler* downsampler, DownsampleMode mode, int dataSize, int targetPoints, double* points, DspContext* context);
+
+/**
+ * Pushes the next count samples. Samples beyond dataSize are ignored.
+ */
+void downsamplerPush(Downsampler* downsampler, const double* data, int count);
+
+/**
+ * Emits the points still pending once all dataSize samples have been pushed.
+ *
+ * @return The number of points written (downsampleCount()), or -1 if fewer than dataSize
+ *         samples were pushed.
+ */
+int downsamplerFinish(Downsampler* downsampler);
+
+void downsamplerFree(Downsampler* downsampler);
+
+/**
+ * One-shot decimation of a whole array.
+ *
+ * @return The number of (x, y) pairs written to points, or -1 on error.
+ *
+ * Example usage:
+ *     double* points = malloc(sizeof(double) * 2 * 2000);
+ *     int count = downsample(DOWNSAMPLE_LTTB, data, dataSize, 2000, points, NULL);
+ */
+int downsample(DownsampleMode mode, const double* data, int dataSize, int targetPoints, double* points, DspContext* context);
+
+#endif // DOWNSAMPLE_H
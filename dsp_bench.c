@@ -0,0 +1,603 @@
+// dsp_bench.c
+//
+// Benchmarks every kernel in data_processing.h, its float32 and Q15/Q31 variants, the
+// sliding-window statistics (against naive recomputation) and the CSV load path on a synthetic
+// 6-axis IMU recording, over a range of sizes and window lengths, and prints the
+// results as JSON (ns/sample and GB/s) so that runs can be compared.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "data_processing.h"
+#include "data_processing_f32.h"
+#include "data_processing_fixed.h"
+#include "csv_loader.h"
+#include "pedestrian.h"
+#include "fft.h"
+#include "imu_signal.h"
+#include "sliding_stats.h"
+#include "parallel_scan.h"
+#include "thread_pool.h"
+
+#define BENCH_MAX_LIST 16
+#define BENCH_CHANNELS 6
+#define BENCH_FULL_SCALE 16.0   // 定點版本以 +-16 g 為滿刻度
+#define BENCH_NAIVE_BUDGET 2e8  // O(n·w) 的對照組超過此運算量就略過
+
+typedef struct {
+    int size;
+    int window;
+    double sampleRate;
+    const double* channels[BENCH_CHANNELS];   // AX..GZ of the synthetic recording
+    double* outputs[BENCH_CHANNELS];
+    double* scratch;
+    // 第一個通道的 float32 / Q15 / Q31 副本
+    const float* channelF32;
+    float* outputF32;
+    float* scratchF32;
+    const int16_t* channelQ15;
+    int16_t* outputQ15;
+    int16_t* scratchQ15;
+    const int32_t* channelQ31;
+    int32_t* outputQ31;
+    int32_t* scratchQ31;
+    ImuRecording recording;   // 完整的合成紀錄，供步態分析使用
+    const char* csvPath;
+    ThreadPool* pool;         // 平行掃描版本使用
+} BenchData;
+
+typedef void (*BenchFunction)(BenchData* data);
+
+typedef struct {
+    const char* name;
+    BenchFunction run;
+    int usesWindow;
+    int channels;             // channels processed per call
+    int bytesPerSample;       // bytes read + written per sample and channel
+    int naive;                // costs O(size * window); skipped above BENCH_NAIVE_BUDGET
+} BenchCase;
+
+static void benchMovingAverage(BenchData* d) {
+    calculateMovingAverage(d->channels[0], d->outputs[0], d->size, d->window);
+}
+
+static void benchMovingAverageMulti(BenchData* d) {
+    calculateMovingAverageMulti(d->channels, d->outputs, BENCH_CHANNELS, d->size, d->window);
+}
+
+static void benchButterworth(BenchData* d) {
+    butterworthLowPassFilter(d->channels[0], d->outputs[0], d->size, 5.0, d->sampleRate);
+}
+
+static void benchDetectMovement(BenchData* d) {
+    detectMovement(d->channels[0], d->outputs[0], d->size, 0.5, d->sampleRate);
+}
+
+static void benchZupt(BenchData* d) {
+    // 閾值為負數時永遠不會偵測到零速度，因此會走完整個陣列
+    applyZupt(d->scratch, d->channels[0], d->size, -1.0, 10);
+}
+
+static void benchApplyLowPass(BenchData* d) {
+    applyLowPassFilter(d->scratch, d->size);
+}
+
+static void benchSubtractBias(BenchData* d) {
+    subtractBias(d->scratch, d->size, 1e-9);
+}
+
+static void benchAnalyzeWalking(BenchData* d) {
+    WalkingResult result;
+    d->recording.sampleCount = d->size;
+    if (analyzeWalkingRecording(&d->recording, NULL, &result, NULL) == 0) {
+        freeWalkingResult(&result);
+    }
+}
+
+// 以 FFT overlap-save 計算 window 點的盒形 FIR，與 calculateMovingAverage 比較
+static void benchFirConvolve(BenchData* d) {
+    double* kernel = malloc(sizeof(double) * (size_t)d->window);
+    if (kernel == NULL) {
+        return;
+    }
+    for (int i = 0; i < d->window; ++i) {
+        kernel[i] = 1.0 / d->window;
+    }
+    firConvolve(kernel, d->window, d->channels[0], d->outputs[0], d->size);
+    free(kernel);
+}
+
+static void benchWelchPsd(BenchData* d) {
+    welchPsdMulti(d->channels, d->outputs, BENCH_CHANNELS, d->size, d->sampleRate, 256, NULL);
+}
+
+static void benchMovingAverageF32(BenchData* d) {
+    calculateMovingAverageF32(d->channelF32, d->outputF32, d->size, d->window);
+}
+
+static void benchButterworthF32(BenchData* d) {
+    butterworthLowPassFilterF32(d->channelF32, d->outputF32, d->size, 5.0, d->sampleRate);
+}
+
+static void benchDetectMovementF32(BenchData* d) {
+    detectMovementF32(d->channelF32, d->outputF32, d->size, 0.5, d->sampleRate);
+}
+
+static void benchApplyLowPassF32(BenchData* d) {
+    applyLowPassFilterF32(d->scratchF32, d->size);
+}
+
+static void benchSubtractBiasF32(BenchData* d) {
+    subtractBiasF32(d->scratchF32, d->size, 1e-9);
+}
+
+static void benchMovingAverageQ15(BenchData* d) {
+    calculateMovingAverageQ15(d->channelQ15, d->outputQ15, d->size, d->window);
+}
+
+static void benchButterworthQ15(BenchData* d) {
+    butterworthLowPassFilterQ15(d->channelQ15, d->outputQ15, d->size, 5.0, d->sampleRate);
+}
+
+static void benchDetectMovementQ15(BenchData* d) {
+    detectMovementQ15(d->channelQ15, d->outputQ15, d->size, 0.5 / BENCH_FULL_SCALE, d->sampleRate);
+}
+
+static void benchApplyLowPassQ15(BenchData* d) {
+    applyLowPassFilterQ15(d->scratchQ15, d->size);
+}
+
+static void benchSubtractBiasQ15(BenchData* d) {
+    subtractBiasQ15(d->scratchQ15, d->size, 0);
+}
+
+static void benchMovingAverageQ31(BenchData* d) {
+    calculateMovingAverageQ31(d->channelQ31, d->outputQ31, d->size, d->window);
+}
+
+static void benchButterworthQ31(BenchData* d) {
+    butterworthLowPassFilterQ31(d->channelQ31, d->outputQ31, d->size, 5.0, d->sampleRate);
+}
+
+static void benchDetectMovementQ31(BenchData* d) {
+    detectMovementQ31(d->channelQ31, d->outputQ31, d->size, 0.5 / BENCH_FULL_SCALE, d->sampleRate);
+}
+
+static void benchApplyLowPassQ31(BenchData* d) {
+    applyLowPassFilterQ31(d->scratchQ31, d->size);
+}
+
+static void benchSubtractBiasQ31(BenchData* d) {
+    subtractBiasQ31(d->scratchQ31, d->size, 0);
+}
+
+static void benchCsvLoad(BenchData* d) {
+    static const int columns[BENCH_CHANNELS] = {5, 6, 7, 8, 9, 10};
+    CsvData csv;
+    if (loadCsvColumns(d->csvPath, columns, BENCH_CHANNELS, 0, &csv) == 0) {
+        freeCsvData(&csv);
+    }
+}
+
+static void benchButterworthParallel(BenchData* d) {
+    parallelButterworthLowPassFilter(d->pool, d->channels[0], d->outputs[0], d->size, 5.0, d->sampleRate);
+}
+
+static void benchApplyLowPassParallel(BenchData* d) {
+    parallelApplyLowPassFilter(d->pool, d->scratch, d->size);
+}
+
+static void benchZuptVelocity(BenchData* d) {
+    integrateVelocityZupt(NULL, d->channels[0], d->outputs[0], d->size, 1.0 / d->sampleRate, 0.05);
+}
+
+static void benchZuptVelocityParallel(BenchData* d) {
+    integrateVelocityZupt(d->pool, d->channels[0], d->outputs[0], d->size, 1.0 / d->sampleRate, 0.05);
+}
+
+static void benchSlidingMinMax(BenchData* d) {
+    SlidingMinMax state;
+    if (slidingMinMaxInit(&state, d->window) != 0) {
+        return;
+    }
+    for (int i = 0; i < d->size; ++i) {
+        slidingMinMaxPush(&state, d->channels[0][i]);
+        d->outputs[0][i] = slidingMin(&state);
+        d->outputs[1][i] = slidingMax(&state);
+    }
+    slidingMinMaxFree(&state);
+}
+
+static void benchSlidingVariance(BenchData* d) {
+    slidingStatistic(SLIDING_VARIANCE, d->channels[0], d->outputs[0], d->size, d->window);
+}
+
+static void benchSlidingMedian(BenchData* d) {
+    slidingStatistic(SLIDING_MEDIAN, d->channels[0], d->outputs[0], d->size, d->window);
+}
+
+// 對照組：每個窗口重新計算，O(n·w)
+static void benchNaiveMinMax(BenchData* d) {
+    for (int i = 0; i < d->size; ++i) {
+        int start = i - d->window + 1 > 0 ? i - d->window + 1 : 0;
+        double minimum = d->channels[0][start];
+        double maximum = minimum;
+        for (int j = start + 1; j <= i; ++j) {
+            double value = d->channels[0][j];
+            minimum = value < minimum ? value : minimum;
+            maximum = value > maximum ? value : maximum;
+        }
+        d->outputs[0][i] = minimum;
+        d->outputs[1][i] = maximum;
+    }
+}
+
+static void benchNaiveVariance(BenchData* d) {
+    for (int i = 0; i < d->size; ++i) {
+        int start = i - d->window + 1 > 0 ? i - d->window + 1 : 0;
+        int count = i - start + 1;
+        double sum = 0.0;
+        for (int j = start; j <= i; ++j) {
+            sum += d->channels[0][j];
+        }
+        double mean = sum / count;
+        double m2 = 0.0;
+        for (int j = start; j <= i; ++j) {
+            double deviation = d->channels[0][j] - mean;
+            m2 += deviation * deviation;
+        }
+        d->outputs[0][i] = m2 / count;
+    }
+}
+
+// 將 values[k] 調整為第 k 小的值（Hoare 分割的 quickselect）
+static double selectKth(double* values, int count, int k) {
+    int left = 0;
+    int right = count - 1;
+    while (left < right) {
+        double pivot = values[left + (right - left) / 2];
+        int i = left;
+        int j = right;
+        while (i <= j) {
+            while (values[i] < pivot) {
+                i++;
+            }
+            while (values[j] > pivot) {
+                j--;
+            }
+            if (i <= j) {
+                double swap = values[i];
+                values[i] = values[j];
+                values[j] = swap;
+                i++;
+                j--;
+            }
+        }
+        if (k <= j) {
+            right = j;
+        } else if (k >= i) {
+            left = i;
+        } else {
+            break;
+        }
+    }
+    return values[k];
+}
+
+static void benchNaiveMedian(BenchData* d) {
+    for (int i = 0; i < d->size; ++i) {
+        int start = i - d->window + 1 > 0 ? i - d->window + 1 : 0;
+        int count = i - start + 1;
+        memcpy(d->scratch, d->channels[0] + start, sizeof(double) * (size_t)count);
+        double median = selectKth(d->scratch, count, count / 2);
+        if (count % 2 == 0) {
+            // 下中位數是左半部的最大值
+            double lower = d->scratch[0];
+            for (int j = 1; j < count / 2; ++j) {
+                lower = d->scratch[j] > lower ? d->scratch[j] : lower;
+            }
+            median = 0.5 * (median + lower);
+        }
+        d->outputs[0][i] = median;
+    }
+}
+
+static const BenchCase kCases[] = {
+    {"calculateMovingAverage", benchMovingAverage, 1, 1, 16, 0},
+    {"calculateMovingAverageMulti", benchMovingAverageMulti, 1, BENCH_CHANNELS, 16, 0},
+    {"butterworthLowPassFilter", benchButterworth, 0, 1, 16, 0},
+    {"detectMovement", benchDetectMovement, 0, 1, 16, 0},
+    {"applyZupt", benchZupt, 0, 1, 16, 0},
+    {"applyLowPassFilter", benchApplyLowPass, 0, 1, 16, 0},
+    {"subtractBias", benchSubtractBias, 0, 1, 16, 0},
+    {"analyzeWalking", benchAnalyzeWalking, 0, 1, 88, 0},
+    {"firConvolve", benchFirConvolve, 1, 1, 16, 0},
+    {"welchPsdMulti", benchWelchPsd, 0, BENCH_CHANNELS, 8, 0},
+    {"calculateMovingAverageF32", benchMovingAverageF32, 1, 1, 8, 0},
+    {"butterworthLowPassFilterF32", benchButterworthF32, 0, 1, 8, 0},
+    {"detectMovementF32", benchDetectMovementF32, 0, 1, 8, 0},
+    {"applyLowPassFilterF32", benchApplyLowPassF32, 0, 1, 8, 0},
+    {"subtractBiasF32", benchSubtractBiasF32, 0, 1, 8, 0},
+    {"calculateMovingAverageQ15", benchMovingAverageQ15, 1, 1, 4, 0},
+    {"butterworthLowPassFilterQ15", benchButterworthQ15, 0, 1, 4, 0},
+    {"detectMovementQ15", benchDetectMovementQ15, 0, 1, 4, 0},
+    {"applyLowPassFilterQ15", benchApplyLowPassQ15, 0, 1, 4, 0},
+    {"subtractBiasQ15", benchSubtractBiasQ15, 0, 1, 4, 0},
+    {"calculateMovingAverageQ31", benchMovingAverageQ31, 1, 1, 8, 0},
+    {"butterworthLowPassFilterQ31", benchButterworthQ31, 0, 1, 8, 0},
+    {"detectMovementQ31", benchDetectMovementQ31, 0, 1, 8, 0},
+    {"applyLowPassFilterQ31", benchApplyLowPassQ31, 0, 1, 8, 0},
+    {"subtractBiasQ31", benchSubtractBiasQ31, 0, 1, 8, 0},
+    {"butterworthLowPassFilterParallel", benchButterworthParallel, 0, 1, 16, 0},
+    {"applyLowPassFilterParallel", benchApplyLowPassParallel, 0, 1, 16, 0},
+    {"integrateVelocityZupt", benchZuptVelocity, 0, 1, 16, 0},
+    {"integrateVelocityZuptParallel", benchZuptVelocityParallel, 0, 1, 16, 0},
+    {"slidingMinMax", benchSlidingMinMax, 1, 1, 24, 0},
+    {"slidingMinMaxNaive", benchNaiveMinMax, 1, 1, 24, 1},
+    {"slidingVariance", benchSlidingVariance, 1, 1, 16, 0},
+    {"slidingVarianceNaive", benchNaiveVariance, 1, 1, 16, 1},
+    {"slidingMedian", benchSlidingMedian, 1, 1, 16, 0},
+    {"slidingMedianNaive", benchNaiveMedian, 1, 1, 16, 1},
+};
+
+static double nowSeconds(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+// 重複執行直到累積 minSeconds 且至少 3 次，回傳最快一次的秒數
+static double timeBest(BenchFunction run, BenchData* data, double minSeconds, int* iterations) {
+    run(data); // 暖機
+    double best = 1e300;
+    double total = 0.0;
+    int count = 0;
+    while (count < 3 || total < minSeconds) {
+        double start = nowSeconds();
+        run(data);
+        double elapsed = nowSeconds() - start;
+        if (elapsed < best) {
+            best = elapsed;
+        }
+        total += elapsed;
+        count++;
+    }
+    *iterations = count;
+    return best;
+}
+
+static int parseList(const char* text, int* values, int maxValues) {
+    int count = 0;
+    const char* p = text;
+    while (*p != '\0' && count < maxValues) {
+        char* end = NULL;
+        long value = strtol(p, &end, 10);
+        if (end == p || value <= 0) {
+            return -1;
+        }
+        values[count++] = (int)value;
+        p = *end == ',' ? end + 1 : end;
+        if (*end != ',' && *end != '\0') {
+            return -1;
+        }
+    }
+    return count;
+}
+
+static void printUsage(const char* programName) {
+    printf("Usage: %s [options]\n", programName);
+    printf("Options:\n");
+    printf("  -h                 Display this help message and exit\n");
+    printf("  --sizes <list>     Comma-separated sample counts (default 1000,10000,100000,1000000)\n");
+    printf("  --windows <list>   Comma-separated window lengths (default 3,50,500)\n");
+    printf("  --rate <hz>        Synthetic sampling rate (default 1000)\n");
+    printf("  --seed <n>         Generator seed (default 1)\n");
+    printf("  --threads <n>      Workers for the parallel-scan cases (default: all online CPUs)\n");
+    printf("  --min-time <s>     Minimum measuring time per case (default 0.05)\n");
+    printf("  --output <path>    Write the JSON report to a file instead of stdout\n");
+}
+
+static void writeResult(FILE* out, int* first, const char* name, int size, int window, int iterations, double seconds, double samples, double bytes) {
+    fprintf(out, "%s\n    {\"name\": \"%s\", \"size\": %d, ", *first ? "" : ",", name, size);
+    if (window > 0) {
+        fprintf(out, "\"window\": %d, ", window);
+    }
+    fprintf(out, "\"iterations\": %d, \"seconds\": %.9f, \"ns_per_sample\": %.4f, \"gb_per_s\": %.4f}",
+            iterations, seconds, seconds * 1e9 / samples, bytes / seconds * 1e-9);
+    *first = 0;
+}
+
+int main(int argc, char* argv[]) {
+    int sizes[BENCH_MAX_LIST] = {1000, 10000, 100000, 1000000};
+    int sizeCount = 4;
+    int windows[BENCH_MAX_LIST] = {3, 50, 500};
+    int windowCount = 3;
+    double minSeconds = 0.05;
+    int threadCount = 0;
+    const char* outputPath = NULL;
+    ImuSignalOptions options;
+    imuSignalDefaultOptions(&options);
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "-h") == 0) {
+            printUsage(argv[0]);
+            return 0;
+        } else if (strcmp(argv[i], "--sizes") == 0 && i + 1 < argc) {
+            sizeCount = parseList(argv[++i], sizes, BENCH_MAX_LIST);
+        } else if (strcmp(argv[i], "--windows") == 0 && i + 1 < argc) {
+            windowCount = parseList(argv[++i], windows, BENCH_MAX_LIST);
+        } else if (strcmp(argv[i], "--rate") == 0 && i + 1 < argc) {
+            options.sampleRate = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            options.seed = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threadCount = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) {
+            minSeconds = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            outputPath = argv[++i];
+        } else {
+            fprintf(stderr, "Error: Unknown or incomplete argument '%s'.\n", argv[i]);
+            printUsage(argv[0]);
+            return 1;
+        }
+        if (sizeCount <= 0 || windowCount <= 0 || options.sampleRate <= 0) {
+            fprintf(stderr, "Error: Invalid value '%s'.\n", argv[i]);
+            return 1;
+        }
+    }
+
+    int maxSize = 0;
+    for (int i = 0; i < sizeCount; ++i) {
+        if (sizes[i] > maxSize) {
+            maxSize = sizes[i];
+        }
+    }
+
+    ImuSignal signal;
+    if (generateImuBenchmarkSignal(&options, maxSize, &signal) != 0) {
+        fprintf(stderr, "Failed to generate synthetic signal\n");
+        return 1;
+    }
+
+    BenchData data;
+    memset(&data, 0, sizeof(data));
+    data.sampleRate = options.sampleRate;
+    double* outputBlock = malloc(sizeof(double) * (size_t)maxSize * (BENCH_CHANNELS + 1));
+    if (outputBlock == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        freeImuSignal(&signal);
+        return 1;
+    }
+    for (int axis = 0; axis < 3; ++axis) {
+        data.channels[axis] = signal.accel[axis];
+        data.channels[3 + axis] = signal.gyro[axis];
+    }
+    data.recording.timestamp = signal.timestamp;
+    for (int i = 0; i < 4; ++i) {
+        data.recording.quaternion[i] = signal.quaternion[i];
+    }
+    for (int axis = 0; axis < 3; ++axis) {
+        data.recording.accel[axis] = signal.accel[axis];
+        data.recording.gyro[axis] = signal.gyro[axis];
+    }
+    data.recording.stride = 1;
+    for (int ch = 0; ch < BENCH_CHANNELS; ++ch) {
+        data.outputs[ch] = outputBlock + (size_t)ch * (size_t)maxSize;
+    }
+    data.scratch = outputBlock + (size_t)BENCH_CHANNELS * (size_t)maxSize;
+
+    // 低精度副本：float32 與 Q15 / Q31 各三個陣列（輸入、輸出、原地處理）
+    float* blockF32 = malloc(sizeof(float) * (size_t)maxSize * 3);
+    int16_t* blockQ15 = malloc(sizeof(int16_t) * (size_t)maxSize * 3);
+    int32_t* blockQ31 = malloc(sizeof(int32_t) * (size_t)maxSize * 3);
+    if (blockF32 == NULL || blockQ15 == NULL || blockQ31 == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        free(blockF32);
+        free(blockQ15);
+        free(blockQ31);
+        free(outputBlock);
+        freeImuSignal(&signal);
+        return 1;
+    }
+    for (int i = 0; i < maxSize; ++i) {
+        blockF32[i] = (float)data.channels[0][i];
+    }
+    convertToQ15(data.channels[0], blockQ15, maxSize, BENCH_FULL_SCALE);
+    convertToQ31(data.channels[0], blockQ31, maxSize, BENCH_FULL_SCALE);
+    data.channelF32 = blockF32;
+    data.outputF32 = blockF32 + maxSize;
+    data.scratchF32 = blockF32 + 2 * (size_t)maxSize;
+    data.channelQ15 = blockQ15;
+    data.outputQ15 = blockQ15 + maxSize;
+    data.scratchQ15 = blockQ15 + 2 * (size_t)maxSize;
+    data.channelQ31 = blockQ31;
+    data.outputQ31 = blockQ31 + maxSize;
+    data.scratchQ31 = blockQ31 + 2 * (size_t)maxSize;
+
+    FILE* out = outputPath != NULL ? fopen(outputPath, "w") : stdout;
+    data.pool = out != NULL ? threadPoolCreate(threadCount) : NULL;
+    if (out == NULL || data.pool == NULL) {
+        if (out == NULL) {
+            perror(outputPath);
+        } else {
+            fprintf(stderr, "Failed to create thread pool\n");
+            if (out != stdout) {
+                fclose(out);
+            }
+        }
+        free(blockF32);
+        free(blockQ15);
+        free(blockQ31);
+        free(outputBlock);
+        freeImuSignal(&signal);
+        return 1;
+    }
+    fprintf(out, "{\n  \"benchmark\": \"dsp_bench\",\n  \"sample_rate\": %g,\n  \"seed\": %llu,\n  \"threads\": %d,\n  \"results\": [",
+            options.sampleRate, options.seed, threadPoolSize(data.pool));
+
+    int first = 1;
+    for (int s = 0; s < sizeCount; ++s) {
+        data.size = sizes[s];
+        memcpy(data.scratch, data.channels[0], sizeof(double) * (size_t)data.size);
+        memcpy(data.scratchF32, data.channelF32, sizeof(float) * (size_t)data.size);
+        memcpy(data.scratchQ15, data.channelQ15, sizeof(int16_t) * (size_t)data.size);
+        memcpy(data.scratchQ31, data.channelQ31, sizeof(int32_t) * (size_t)data.size);
+
+        for (size_t c = 0; c < sizeof(kCases) / sizeof(kCases[0]); ++c) {
+            const BenchCase* benchCase = &kCases[c];
+            for (int w = 0; w < (benchCase->usesWindow ? windowCount : 1); ++w) {
+                data.window = benchCase->usesWindow ? windows[w] : 0;
+                if (benchCase->naive && (double)data.size * data.window > BENCH_NAIVE_BUDGET) {
+                    fprintf(stderr, "%-32s n=%-9d w=%-5d skipped (naive)\n", benchCase->name, data.size, data.window);
+                    continue;
+                }
+                int iterations = 0;
+                double seconds = timeBest(benchCase->run, &data, minSeconds, &iterations);
+                double samples = (double)data.size * benchCase->channels;
+                writeResult(out, &first, benchCase->name, data.size, data.window, iterations, seconds, samples, samples * benchCase->bytesPerSample);
+                fprintf(stderr, "%-32s n=%-9d w=%-5d %8.3f ns/sample\n", benchCase->name, data.size, data.window, seconds * 1e9 / samples);
+            }
+        }
+
+        // CSV 讀取：將合成資料寫成 demo.csv 格式後量測載入六軸
+        char csvPath[] = "/tmp/dsp_bench_XXXXXX";
+        int fd = mkstemp(csvPath);
+        if (fd < 0) {
+            perror("mkstemp");
+            continue;
+        }
+        close(fd);
+        ImuSignal prefix = signal;
+        prefix.sampleCount = data.size;
+        if (writeImuSignalCsv(&prefix, csvPath) == 0) {
+            FILE* csvFile = fopen(csvPath, "r");
+            double fileBytes = 0.0;
+            if (csvFile != NULL) {
+                fseek(csvFile, 0, SEEK_END);
+                fileBytes = (double)ftell(csvFile);
+                fclose(csvFile);
+            }
+            data.csvPath = csvPath;
+            int iterations = 0;
+            double seconds = timeBest(benchCsvLoad, &data, minSeconds, &iterations);
+            writeResult(out, &first, "loadCsvColumns", data.size, 0, iterations, seconds, (double)data.size, fileBytes);
+            fprintf(stderr, "%-32s n=%-9d         %8.3f ns/row\n", "loadCsvColumns", data.size, seconds * 1e9 / data.size);
+        }
+        unlink(csvPath);
+    }
+    fprintf(out, "\n  ]\n}\n");
+
+    if (out != stdout) {
+        fclose(out);
+    }
+    threadPoolDestroy(data.pool);
+    free(blockF32);
+    free(blockQ15);
+    free(blockQ31);
+    free(outputBlock);
+    freeImuSignal(&signal);
+    return 0;
+}
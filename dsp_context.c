@@ -0,0 +1,167 @@
+// dsp_context.c
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dsp_context.h"
+#include "dsp_stats.h"
+
+// 區塊標頭佔一整條快取線，資料區因此保持 64 位元組對齊
+struct DspArenaBlock {
+    DspArenaBlock* next;
+    size_t size;             // 資料區的位元組數
+};
+
+static unsigned char* blockData(DspArenaBlock* block) {
+    return (unsigned char*)block + DSP_CONTEXT_ALIGNMENT;
+}
+
+static size_t roundUp(size_t size) {
+    return (size + DSP_CONTEXT_ALIGNMENT - 1) & ~(size_t)(DSP_CONTEXT_ALIGNMENT - 1);
+}
+
+static DspArenaBlock* allocateBlock(DspContext* context, size_t size) {
+    DspArenaBlock* block = aligned_alloc(DSP_CONTEXT_ALIGNMENT, DSP_CONTEXT_ALIGNMENT + size);
+    if (block == NULL) {
+        return NULL;
+    }
+    block->next = NULL;
+    block->size = size;
+    context->capacity += size;
+    context->blockAllocations++;
+    DSP_STATS_ADD(DSP_COUNTER_BUFFER_ALLOCATIONS, 1);
+    return block;
+}
+
+static void freeChain(DspContext* context, DspArenaBlock* block) {
+    while (block != NULL) {
+        DspArenaBlock* next = block->next;
+        context->capacity -= block->size;
+        free(block);
+        block = next;
+    }
+}
+
+int dspContextInit(DspContext* context, size_t initialBytes) {
+    if (context == NULL) {
+        return -1;
+    }
+    memset(context, 0, sizeof(*context));
+    if (initialBytes > 0) {
+        context->first = allocateBlock(context, roundUp(initialBytes));
+        if (context->first == NULL) {
+            return -1;
+        }
+        context->current = context->first;
+    }
+    return 0;
+}
+
+// 目前區塊放不下時：沿用下一個夠大的區塊，否則以更大的區塊取代其後的鏈
+static DspArenaBlock* advanceBlock(DspContext* context, size_t size) {
+    DspArenaBlock* previous = context->current;
+    DspArenaBlock* next = previous != NULL ? previous->next : NULL;
+    if (next != NULL && next->size >= size) {
+        return next;
+    }
+    freeChain(context, next);
+
+    size_t blockSize = context->capacity > DSP_CONTEXT_MIN_BLOCK ? context->capacity : DSP_CONTEXT_MIN_BLOCK;
+    if (blockSize < size) {
+        blockSize = size;
+    }
+    DspArenaBlock* block = allocateBlock(context, blockSize);
+    if (previous != NULL) {
+        previous->next = block;
+    } else {
+        context->first = block;
+    }
+    return block;
+}
+
+void* dspContextAlloc(DspContext* context, size_t size) {
+    if (context == NULL || size > SIZE_MAX / 2) {
+        return NULL;
+    }
+    size = roundUp(size > 0 ? size : 1);
+    DspArenaBlock* block = context->current;
+    size_t offset = context->offset;
+    if (block == NULL || block->size - offset < size) {
+        block = advanceBlock(context, size);
+        if (block == NULL) {
+            return NULL;
+        }
+        offset = 0;
+    }
+    context->current = block;
+    context->offset = offset + size;
+    context->inUse += size;
+    if (context->inUse > context->highWater) {
+        context->highWater = context->inUse;
+    }
+    return blockData(block) + offset;
+}
+
+double* dspContextAllocDoubles(DspContext* context, size_t count) {
+    if (count > SIZE_MAX / 2 / sizeof(double)) {
+        return NULL;
+    }
+    return dspContextAlloc(context, sizeof(double) * count);
+}
+
+DspContextMark dspContextMark(const DspContext* context) {
+    DspContextMark mark = {context->current, context->offset, context->inUse};
+    return mark;
+}
+
+void dspContextRelease(DspContext* context, const DspContextMark* mark) {
+    if (context == NULL || mark == NULL) {
+        return;
+    }
+    if (mark->inUse == 0) {
+        dspContextReset(context);
+        return;
+    }
+    context->current = mark->block;
+    context->offset = mark->offset;
+    context->inUse = mark->inUse;
+}
+
+void dspContextReset(DspContext* context) {
+    if (context == NULL) {
+        return;
+    }
+    // 已成長出多個區塊時合併成一個，下一輪相同用量便不必跨區塊
+    if (context->first != NULL && context->first->next != NULL) {
+        size_t total = context->capacity;
+        freeChain(context, context->first);
+        context->first = allocateBlock(context, total);
+    }
+    context->current = context->first;
+    context->offset = 0;
+    context->inUse = 0;
+}
+
+void dspContextFree(DspContext* context) {
+    if (context == NULL) {
+        return;
+    }
+    freeChain(context, context->first);
+    memset(context, 0, sizeof(*context));
+}
+
+void* dspContextScratch(DspContext* context, size_t size, DspContextMark* mark) {
+    if (context == NULL) {
+        return malloc(size > 0 ? size : 1);
+    }
+    *mark = dspContextMark(context);
+    return dspContextAlloc(context, size);
+}
+
+void dspContextScratchRelease(DspContext* context, void* memory, const DspContextMark* mark) {
+    if (context == NULL) {
+        free(memory);
+    } else {
+        dspContextRelease(context, mark);
+    }
+}
@@ -0,0 +1,97 @@
+// dsp_context.h
+
+#ifndef DSP_CONTEXT_H
+#define DSP_CONTEXT_H
+
+#include <stddef.h>
+
+/*
+ * Processing context: a growable arena of 64-byte-aligned scratch memory.
+ *
+ * Buffers that live for one axis, one file or one pipeline are carved out of the arena
+ * with a pointer bump instead of malloc; dspContextMark() / dspContextRelease() hand the
+ * memory back in LIFO order. The arena grows by chaining a new block (at least as large
+ * as everything allocated so far) when a request does not fit, and releasing back to the
+ * start folds the chain into one block, so after the first axis or file the same
+ * memory is reused without touching the allocator. Every buffer starts on a cache line,
+ * which also satisfies the alignment of any SIMD load.
+ *
+ * A context is not thread-safe; give each thread its own.
+ */
+
+#define DSP_CONTEXT_ALIGNMENT 64
+#define DSP_CONTEXT_MIN_BLOCK (64 * 1024)   // smallest block the arena allocates (bytes)
+
+typedef struct DspArenaBlock DspArenaBlock;
+
+typedef struct {
+    DspArenaBlock* first;     // block chain, oldest first
+    DspArenaBlock* current;   // block allocations are taken from
+    size_t offset;            // bytes used in current
+    size_t inUse;             // bytes handed out and not released
+    size_t capacity;          // bytes in all blocks
+    size_t highWater;         // peak of inUse
+    int blockAllocations;     // blocks allocated over the context's lifetime
+} DspContext;
+
+/**
+ * A position in the arena, see dspContextMark().
+ */
+typedef struct {
+    DspArenaBlock* block;
+    size_t offset;
+    size_t inUse;
+} DspContextMark;
+
+/**
+ * Initializes a context, optionally reserving initialBytes up front.
+ *
+ * @return 0 on success, -1 if the reservation cannot be allocated.
+ */
+int dspContextInit(DspContext* context, size_t initialBytes);
+
+/**
+ * Returns size bytes aligned to DSP_CONTEXT_ALIGNMENT, valid until the context is
+ * released past this allocation or freed. The memory is not cleared.
+ *
+ * @return The memory, or NULL if the arena cannot grow.
+ */
+void* dspContextAlloc(DspContext* context, size_t size);
+
+/**
+ * dspContextAlloc() for count doubles.
+ */
+double* dspContextAllocDoubles(DspContext* context, size_t count);
+
+/**
+ * Records the current position; dspContextRelease() returns everything allocated after it.
+ *
+ * Example usage:
+ *     DspContextMark mark = dspContextMark(&context);
+ *     double* output = dspContextAllocDoubles(&context, count);
+ *     ...
+ *     dspContextRelease(&context, &mark);
+ */
+DspContextMark dspContextMark(const DspContext* context);
+
+void dspContextRelease(DspContext* context, const DspContextMark* mark);
+
+/**
+ * Releases every allocation. Blocks are kept (merged into one) for reuse.
+ */
+void dspContextReset(DspContext* context);
+
+/**
+ * Returns all memory to the system.
+ */
+void dspContextFree(DspContext* context);
+
+/**
+ * Scratch for kernels that accept an optional context: taken from context when it is not
+ * NULL, otherwise from the heap. Pass the same mark to dspContextScratchRelease().
+ */
+void* dspContextScratch(DspContext* context, size_t size, DspContextMark* mark);
+
+void dspContextScratchRelease(DspContext* context, void* memory, const DspContextMark* mark);
+
+#endif // DSP_CONTEXT_H
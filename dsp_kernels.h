@@ -0,0 +1,66 @@
+// dsp_kernels.h
+//
+// Per-sample kernels shared by the batch functions in data_processing.c and the
+// stateful streaming filters. Keeping a single definition of each step guarantees that
+// both paths perform the same floating-point operations in the same order, so their
+// outputs are bit-identical. Internal header, not part of the public API.
+
+#ifndef DSP_KERNELS_H
+#define DSP_KERNELS_H
+
+#include <math.h>
+
+#define DSP_PI 3.14159265358979323846
+
+/*
+ * Neumaier compensated summation step. The running moving-average sum adds and
+ * removes every sample once, so without compensation the rounding error would
+ * accumulate over the whole recording instead of staying bounded by the window.
+ */
+static inline void neumaierAdd(double* sum, double* compensation, double value) {
+    double t = *sum + value;
+    if (fabs(*sum) >= fabs(value)) {
+        *compensation += (*sum - t) + value;
+    } else {
+        *compensation += (value - t) + *sum;
+    }
+    *sum = t;
+}
+
+/*
+ * Average of the first count samples during the moving-average ramp-up, summed from the
+ * newest sample back to the oldest exactly like the original O(n * windowSize) loop, so
+ * the start of the array is bit-identical to it. Only used for the first windowSize
+ * outputs, i.e. while count <= windowSize.
+ */
+static inline double rampAverage(const double* data, int count) {
+    double sum = 0.0;
+    for (int j = count - 1; j >= 0; --j) {
+        sum += data[j];
+    }
+    return sum / count;
+}
+
+// 一階 RC 低通濾波器的平滑係數
+static inline double butterworthAlpha(double cutoffFrequency, double samplingRate) {
+    double dt = 1.0 / samplingRate;
+    double RC = 1.0 / (2 * DSP_PI * cutoffFrequency);
+    return dt / (RC + dt);
+}
+
+static inline double lowPassStep(double alpha, double input, double previous) {
+    return alpha * input + (1 - alpha) * previous;
+}
+
+// 以中央差分計算二階微分，超過閾值回傳 1.0
+static inline double movementStep(double previous, double current, double next, double dtSquared, double threshold) {
+    double acceleration = (next - 2 * current + previous) / dtSquared;
+    return fabs(acceleration) > threshold ? 1.0 : 0.0;
+}
+
+// 首尾樣本的二階微分視為 0，再與閾值比較
+static inline double movementEdge(double threshold) {
+    return 0.0 > threshold ? 1.0 : 0.0;
+}
+
+#endif // DSP_KERNELS_H
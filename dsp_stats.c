@@ -0,0 +1,88 @@
+// dsp_stats.c
+#include <time.h>
+
+#include "dsp_stats.h"
+
+atomic_int dspStatsActive = 0;
+
+static atomic_llong counters[DSP_COUNTER_COUNT];
+static atomic_llong stageCalls[DSP_STAGE_COUNT];
+static atomic_llong stageWallNs[DSP_STAGE_COUNT];
+static atomic_llong stageCpuNs[DSP_STAGE_COUNT];
+static long long totalWallStart;
+static long long totalCpuStart;
+
+static const char* const kCounterNames[DSP_COUNTER_COUNT] = {
+    "bytes_read",
+    "rows_parsed",
+    "samples_processed",
+    "bytes_written",
+    "buffer_allocations",
+};
+
+static const char* const kStageNames[DSP_STAGE_COUNT] = {
+    "csv_parse",
+    "filter",
+    "temp_write",
+    "gnuplot",
+};
+
+static long long clockNs(clockid_t clock) {
+    struct timespec now;
+    clock_gettime(clock, &now);
+    return (long long)now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+void dspStatsEnable(int enabled) {
+    if (enabled) {
+        for (int i = 0; i < DSP_COUNTER_COUNT; ++i) {
+            atomic_store(&counters[i], 0);
+        }
+        for (int i = 0; i < DSP_STAGE_COUNT; ++i) {
+            atomic_store(&stageCalls[i], 0);
+            atomic_store(&stageWallNs[i], 0);
+            atomic_store(&stageCpuNs[i], 0);
+        }
+        totalWallStart = clockNs(CLOCK_MONOTONIC);
+        totalCpuStart = clockNs(CLOCK_PROCESS_CPUTIME_ID);
+    }
+    atomic_store(&dspStatsActive, enabled ? 1 : 0);
+}
+
+void dspStatsAdd(DspCounter counter, long long amount) {
+    atomic_fetch_add_explicit(&counters[counter], amount, memory_order_relaxed);
+}
+
+void dspTimerBegin(DspTimer* timer) {
+    timer->active = dspStatsEnabled();
+    if (timer->active) {
+        timer->wallStart = clockNs(CLOCK_MONOTONIC);
+        timer->cpuStart = clockNs(CLOCK_THREAD_CPUTIME_ID);
+    }
+}
+
+void dspTimerEnd(DspTimer* timer, DspStage stage) {
+    if (!timer->active) {
+        return;
+    }
+    atomic_fetch_add_explicit(&stageWallNs[stage], clockNs(CLOCK_MONOTONIC) - timer->wallStart, memory_order_relaxed);
+    atomic_fetch_add_explicit(&stageCpuNs[stage], clockNs(CLOCK_THREAD_CPUTIME_ID) - timer->cpuStart, memory_order_relaxed);
+    atomic_fetch_add_explicit(&stageCalls[stage], 1, memory_order_relaxed);
+}
+
+void dspStatsPrintJson(FILE* out) {
+    double wallSeconds = (clockNs(CLOCK_MONOTONIC) - totalWallStart) * 1e-9;
+    double cpuSeconds = (clockNs(CLOCK_PROCESS_CPUTIME_ID) - totalCpuStart) * 1e-9;
+
+    fprintf(out, "{\n  \"wall_seconds\": %.6f,\n  \"cpu_seconds\": %.6f,\n  \"counters\": {", wallSeconds, cpuSeconds);
+    for (int i = 0; i < DSP_COUNTER_COUNT; ++i) {
+        fprintf(out, "%s\n    \"%s\": %lld", i == 0 ? "" : ",", kCounterNames[i], (long long)atomic_load(&counters[i]));
+    }
+    fprintf(out, "\n  },\n  \"stages\": {");
+    for (int i = 0; i < DSP_STAGE_COUNT; ++i) {
+        fprintf(out, "%s\n    \"%s\": {\"calls\": %lld, \"wall_seconds\": %.6f, \"cpu_seconds\": %.6f}",
+                i == 0 ? "" : ",", kStageNames[i], (long long)atomic_load(&stageCalls[i]),
+                atomic_load(&stageWallNs[i]) * 1e-9, atomic_load(&stageCpuNs[i]) * 1e-9);
+    }
+    fprintf(out, "\n  }\n}\n");
+}
@@ -0,0 +1,80 @@
+// dsp_stats.h
+
+#ifndef DSP_STATS_H
+#define DSP_STATS_H
+
+#include <stdio.h>
+#include <stdatomic.h>
+
+/*
+ * Lightweight hot-path instrumentation: per-stage wall/CPU timers and global counters.
+ *
+ * Instrumentation points use the DSP_STATS_* macros below. When the build is configured
+ * without DSP_ENABLE_STATS (CMake option of the same name) they compile to nothing. When
+ * compiled in but not enabled at runtime (dspStatsEnable()), each point costs one relaxed
+ * atomic load and a predictable branch; points sit at block / file granularity, never
+ * inside per-sample loops. All updates are atomic, so batch mode threads can share them.
+ */
+
+typedef enum {
+    DSP_STAGE_CSV_PARSE,
+    DSP_STAGE_FILTER,
+    DSP_STAGE_TEMP_WRITE,
+    DSP_STAGE_GNUPLOT,
+    DSP_STAGE_COUNT
+} DspStage;
+
+typedef enum {
+    DSP_COUNTER_BYTES_READ,
+    DSP_COUNTER_ROWS_PARSED,
+    DSP_COUNTER_SAMPLES_PROCESSED,
+    DSP_COUNTER_BYTES_WRITTEN,
+    DSP_COUNTER_BUFFER_ALLOCATIONS,   // sample buffers only: CSV storage and read buffer, pipeline blocks, arena blocks
+    DSP_COUNTER_COUNT
+} DspCounter;
+
+typedef struct {
+    long long wallStart;
+    long long cpuStart;
+    int active;
+} DspTimer;
+
+extern atomic_int dspStatsActive;
+
+static inline int dspStatsEnabled(void) {
+    return atomic_load_explicit(&dspStatsActive, memory_order_relaxed);
+}
+
+/**
+ * Turns collection on or off and, when turning it on, resets all counters and starts
+ * the wall/CPU clocks reported as totals.
+ */
+void dspStatsEnable(int enabled);
+
+void dspStatsAdd(DspCounter counter, long long amount);
+
+void dspTimerBegin(DspTimer* timer);
+
+/**
+ * Adds the wall and thread-CPU time since dspTimerBegin() to stage.
+ */
+void dspTimerEnd(DspTimer* timer, DspStage stage);
+
+/**
+ * Prints every counter, every stage (calls, wall and CPU seconds) and the process totals
+ * since dspStatsEnable(1) as a JSON object.
+ */
+void dspStatsPrintJson(FILE* out);
+
+#ifdef DSP_ENABLE_STATS
+#define DSP_STATS_ADD(counter, amount) \
+    do { if (dspStatsEnabled()) dspStatsAdd((counter), (long long)(amount)); } while (0)
+#define DSP_STATS_TIMER_BEGIN(timer) DspTimer timer; dspTimerBegin(&timer)
+#define DSP_STATS_TIMER_END(timer, stage) dspTimerEnd(&timer, (stage))
+#else
+#define DSP_STATS_ADD(counter, amount) ((void)0)
+#define DSP_STATS_TIMER_BEGIN(timer) ((void)0)
+#define DSP_STATS_TIMER_END(timer, stage) ((void)0)
+#endif
+
+#endif // DSP_STATS_H
@@ -0,0 +1,410 @@
+// fft.c
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+
+#include "fft.h"
+#include "dsp_kernels.h"
+
+#define FFT_CACHE_SLOTS 31          // 2^1 .. 2^30
+#define FIR_MIN_FFT_SIZE 64
+
+static const FftPlan* planCache[FFT_CACHE_SLOTS];
+static pthread_mutex_t planCacheLock = PTHREAD_MUTEX_INITIALIZER;
+
+static int isPowerOfTwo(int n) {
+    return n >= 2 && (n & (n - 1)) == 0;
+}
+
+static int log2Exact(int n) {
+    int bits = 0;
+    while ((1 << bits) < n) {
+        bits++;
+    }
+    return bits;
+}
+
+int fftNextPowerOfTwo(int n) {
+    int size = 2;
+    while (size < n) {
+        if (size > (1 << 29)) {
+            return -1;
+        }
+        size <<= 1;
+    }
+    return size;
+}
+
+FftPlan* fftPlanCreate(int size) {
+    if (!isPowerOfTwo(size)) {
+        return NULL;
+    }
+    FftPlan* plan = calloc(1, sizeof(FftPlan));
+    if (plan == NULL) {
+        return NULL;
+    }
+    int half = size / 2;
+    plan->size = size;
+    plan->half = half;
+    plan->bitReverse = malloc(sizeof(int) * (size_t)half);
+    plan->twiddle = malloc(sizeof(double) * (size_t)(half > 1 ? half : 2));
+    plan->realTwiddle = malloc(sizeof(double) * (size_t)(half + 2));
+    if (plan->bitReverse == NULL || plan->twiddle == NULL || plan->realTwiddle == NULL) {
+        fftPlanDestroy(plan);
+        return NULL;
+    }
+
+    int bits = log2Exact(half);
+    for (int i = 0; i < half; ++i) {
+        int reversed = 0;
+        for (int b = 0; b < bits; ++b) {
+            reversed |= ((i >> b) & 1) << (bits - 1 - b);
+        }
+        plan->bitReverse[i] = reversed;
+    }
+    for (int j = 0; j < half / 2; ++j) {
+        double angle = -2.0 * DSP_PI * j / half;
+        plan->twiddle[2 * j] = cos(angle);
+        plan->twiddle[2 * j + 1] = sin(angle);
+    }
+    for (int k = 0; k <= half / 2; ++k) {
+        double angle = -2.0 * DSP_PI * k / size;
+        plan->realTwiddle[2 * k] = cos(angle);
+        plan->realTwiddle[2 * k + 1] = sin(angle);
+    }
+    return plan;
+}
+
+void fftPlanDestroy(FftPlan* plan) {
+    if (plan == NULL) {
+        return;
+    }
+    free(plan->bitReverse);
+    free(plan->twiddle);
+    free(plan->realTwiddle);
+    free(plan);
+}
+
+const FftPlan* fftPlanCached(int size) {
+    if (!isPowerOfTwo(size) || log2Exact(size) >= FFT_CACHE_SLOTS) {
+        return NULL;
+    }
+    int slot = log2Exact(size);
+    pthread_mutex_lock(&planCacheLock);
+    if (planCache[slot] == NULL) {
+        planCache[slot] = fftPlanCreate(size);
+    }
+    const FftPlan* plan = planCache[slot];
+    pthread_mutex_unlock(&planCacheLock);
+    return plan;
+}
+
+void fftPlanCacheClear(void) {
+    pthread_mutex_lock(&planCacheLock);
+    for (int slot = 0; slot < FFT_CACHE_SLOTS; ++slot) {
+        fftPlanDestroy((FftPlan*)planCache[slot]);
+        planCache[slot] = NULL;
+    }
+    pthread_mutex_unlock(&planCacheLock);
+}
+
+// 半長度的原地複數 FFT（基 2、時間抽取），data 為交錯的實部 / 虛部
+static void complexTransform(const FftPlan* plan, double* data, int inverse) {
+    int n = plan->half;
+    for (int i = 0; i < n; ++i) {
+        int j = plan->bitReverse[i];
+        if (j > i) {
+            double re = data[2 * i];
+            double im = data[2 * i + 1];
+            data[2 * i] = data[2 * j];
+            data[2 * i + 1] = data[2 * j + 1];
+            data[2 * j] = re;
+            data[2 * j + 1] = im;
+        }
+    }
+    double sign = inverse ? -1.0 : 1.0;
+    for (int length = 2; length <= n; length <<= 1) {
+        int halfLength = length / 2;
+        int step = n / length;
+        for (int start = 0; start < n; start += length) {
+            for (int j = 0; j < halfLength; ++j) {
+                double wr = plan->twiddle[2 * j * step];
+                double wi = sign * plan->twiddle[2 * j * step + 1];
+                double* a = data + 2 * (start + j);
+                double* b = data + 2 * (start + j + halfLength);
+                double vr = b[0] * wr - b[1] * wi;
+                double vi = b[0] * wi + b[1] * wr;
+                b[0] = a[0] - vr;
+                b[1] = a[1] - vi;
+                a[0] += vr;
+                a[1] += vi;
+            }
+        }
+    }
+}
+
+/*
+ * The N-point real transform packs x into N/2 complex points z[k] = x[2k] + i x[2k+1]
+ * and splits Z into the spectra of the even (E) and odd (O) samples:
+ * X[k] = E[k] + W^k O[k] and X[N/2 - k] = conj(E[k] - W^k O[k]), W = e^(-2 pi i / N).
+ */
+void fftRealForward(const FftPlan* plan, const double* input, double* spectrum) {
+    int half = plan->half;
+    memcpy(spectrum, input, sizeof(double) * (size_t)plan->size);
+    complexTransform(plan, spectrum, 0);
+
+    double re0 = spectrum[0];
+    double im0 = spectrum[1];
+    spectrum[0] = re0 + im0;
+    spectrum[1] = 0.0;
+    spectrum[2 * half] = re0 - im0;
+    spectrum[2 * half + 1] = 0.0;
+
+    for (int k = 1; k <= half / 2; ++k) {
+        int m = half - k;
+        double zkr = spectrum[2 * k];
+        double zki = spectrum[2 * k + 1];
+        double zmr = spectrum[2 * m];
+        double zmi = spectrum[2 * m + 1];
+        // E = (Z[k] + conj(Z[m])) / 2，O = (Z[k] - conj(Z[m])) / 2i
+        double er = 0.5 * (zkr + zmr);
+        double ei = 0.5 * (zki - zmi);
+        double or = 0.5 * (zki + zmi);
+        double oi = -0.5 * (zkr - zmr);
+        double wr = plan->realTwiddle[2 * k];
+        double wi = plan->realTwiddle[2 * k + 1];
+        double tr = wr * or - wi * oi;
+        double ti = wr * oi + wi * or;
+        spectrum[2 * k] = er + tr;
+        spectrum[2 * k + 1] = ei + ti;
+        if (m != k) {
+            spectrum[2 * m] = er - tr;
+            spectrum[2 * m + 1] = -(ei - ti);
+        }
+    }
+}
+
+void fftRealInverse(const FftPlan* plan, const double* spectrum, double* output) {
+    int half = plan->half;
+    double first = spectrum[0];
+    double last = spectrum[2 * half];
+    output[0] = 0.5 * (first + last);
+    output[1] = 0.5 * (first - last);
+
+    for (int k = 1; k <= half / 2; ++k) {
+        int m = half - k;
+        double xkr = spectrum[2 * k];
+        double xki = spectrum[2 * k + 1];
+        double xmr = spectrum[2 * m];
+        double xmi = spectrum[2 * m + 1];
+        // E = (X[k] + conj(X[m])) / 2，O = (X[k] - conj(X[m])) / (2 W^k)，Z[k] = E + iO
+        double er = 0.5 * (xkr + xmr);
+        double ei = 0.5 * (xki - xmi);
+        double dr = 0.5 * (xkr - xmr);
+        double di = 0.5 * (xki + xmi);
+        double wr = plan->realTwiddle[2 * k];
+        double wi = plan->realTwiddle[2 * k + 1];
+        double or = dr * wr + di * wi;
+        double oi = di * wr - dr * wi;
+        output[2 * k] = er - oi;
+        output[2 * k + 1] = ei + or;
+        if (m != k) {
+            // Z[m] = conj(E) + i conj(O)
+            output[2 * m] = er + oi;
+            output[2 * m + 1] = -ei + or;
+        }
+    }
+
+    complexTransform(plan, output, 1);
+    double scale = 1.0 / half;
+    for (int i = 0; i < plan->size; ++i) {
+        output[i] *= scale;
+    }
+}
+
+int firFilterInit(FirFilter* filter, const double* kernel, int kernelLength, int fftSize) {
+    if (filter == NULL || kernel == NULL || kernelLength <= 0) {
+        return -1;
+    }
+    memset(filter, 0, sizeof(*filter));
+    if (fftSize == 0) {
+        fftSize = fftNextPowerOfTwo(kernelLength > FIR_MIN_FFT_SIZE / 4 ? 4 * kernelLength : FIR_MIN_FFT_SIZE);
+    }
+    if (!isPowerOfTwo(fftSize) || fftSize <= kernelLength) {
+        return -1;
+    }
+    filter->plan = fftPlanCached(fftSize);
+    // 四個陣列共用一次配置：kernelSpectrum、spectrum（各 N + 2）、block、output（各 N）
+    double* memory = calloc((size_t)(4 * fftSize + 4), sizeof(double));
+    if (filter->plan == NULL || memory == NULL) {
+        free(memory);
+        return -1;
+    }
+    filter->kernelLength = kernelLength;
+    filter->blockLength = fftSize - kernelLength + 1;
+    filter->kernelSpectrum = memory;
+    filter->spectrum = memory + fftSize + 2;
+    filter->block = memory + 2 * fftSize + 4;
+    filter->output = memory + 3 * fftSize + 4;
+
+    memcpy(filter->block, kernel, sizeof(double) * (size_t)kernelLength);
+    fftRealForward(filter->plan, filter->block, filter->kernelSpectrum);
+    memset(filter->block, 0, sizeof(double) * (size_t)fftSize);
+    return 0;
+}
+
+void firFilterProcess(FirFilter* filter, const double* inputData, double* outputData, int dataSize) {
+    if (filter == NULL || filter->plan == NULL || inputData == NULL || outputData == NULL) {
+        return;
+    }
+    const int fftSize = filter->plan->size;
+    const int history = filter->kernelLength - 1;
+    const int bins = fftSize / 2 + 1;
+
+    int position = 0;
+    while (position < dataSize) {
+        int chunk = filter->blockLength - filter->filled;
+        if (chunk > dataSize - position) {
+            chunk = dataSize - position;
+        }
+        // 區塊中尚未填入的部分保持為 0，只取已填入樣本對應的有效輸出
+        memcpy(filter->block + history + filter->filled, inputData + position, sizeof(double) * (size_t)chunk);
+
+        fftRealForward(filter->plan, filter->block, filter->spectrum);
+        for (int k = 0; k < bins; ++k) {
+            double xr = filter->spectrum[2 * k];
+            double xi = filter->spectrum[2 * k + 1];
+            double hr = filter->kernelSpectrum[2 * k];
+            double hi = filter->kernelSpectrum[2 * k + 1];
+            filter->spectrum[2 * k] = xr * hr - xi * hi;
+            filter->spectrum[2 * k + 1] = xr * hi + xi * hr;
+        }
+        fftRealInverse(filter->plan, filter->spectrum, filter->output);
+        memcpy(outputData + position, filter->output + history + filter->filled, sizeof(double) * (size_t)chunk);
+
+        filter->filled += chunk;
+        position += chunk;
+        if (filter->filled == filter->blockLength) {
+            // 最後 kernelLength - 1 個樣本成為下一個區塊的歷史
+            memmove(filter->block, filter->block + filter->blockLength, sizeof(double) * (size_t)history);
+            memset(filter->block + history, 0, sizeof(double) * (size_t)filter->blockLength);
+            filter->filled = 0;
+        }
+    }
+}
+
+void firFilterReset(FirFilter* filter) {
+    if (filter == NULL || filter->block == NULL) {
+        return;
+    }
+    memset(filter->block, 0, sizeof(double) * (size_t)filter->plan->size);
+    filter->filled = 0;
+}
+
+void firFilterFree(FirFilter* filter) {
+    if (filter == NULL) {
+        return;
+    }
+    free(filter->kernelSpectrum); // 所有陣列共用同一塊記憶體
+    memset(filter, 0, sizeof(*filter));
+}
+
+int firConvolve(const double* kernel, int kernelLength, const double* inputData, double* outputData, int dataSize) {
+    if (inputData == NULL || outputData == NULL || dataSize < 0) {
+        return -1;
+    }
+    FirFilter filter;
+    if (firFilterInit(&filter, kernel, kernelLength, 0) != 0) {
+        return -1;
+    }
+    firFilterProcess(&filter, inputData, outputData, dataSize);
+    firFilterFree(&filter);
+    return 0;
+}
+
+int firDesignLowPass(double* kernel, int kernelLength, double cutoffFrequency, double samplingRate) {
+    if (kernel == NULL || kernelLength <= 0 || cutoffFrequency <= 0 || samplingRate <= 0 || cutoffFrequency >= samplingRate / 2) {
+        return -1;
+    }
+    double normalized = cutoffFrequency / samplingRate;
+    double center = 0.5 * (kernelLength - 1);
+    double sum = 0.0;
+    for (int i = 0; i < kernelLength; ++i) {
+        double t = i - center;
+        double sinc = t == 0.0 ? 2.0 * normalized : sin(2.0 * DSP_PI * normalized * t) / (DSP_PI * t);
+        double window = kernelLength > 1 ? 0.54 - 0.46 * cos(2.0 * DSP_PI * i / (kernelLength - 1)) : 1.0;
+        kernel[i] = sinc * window;
+        sum += kernel[i];
+    }
+    for (int i = 0; i < kernelLength; ++i) {
+        kernel[i] /= sum;
+    }
+    return 0;
+}
+
+int welchPsd(const double* inputData, int dataSize, double sampleRate, int segmentLength, double* psd, DspContext* context) {
+    if (inputData == NULL || psd == NULL || sampleRate <= 0 || !isPowerOfTwo(segmentLength) || dataSize < segmentLength) {
+        return -1;
+    }
+    const FftPlan* plan = fftPlanCached(segmentLength);
+    // window、segment（各 L）與 spectrum（L + 2）
+    DspContextMark mark;
+    double* memory = dspContextScratch(context, sizeof(double) * (size_t)(3 * segmentLength + 2), &mark);
+    if (plan == NULL || memory == NULL) {
+        dspContextScratchRelease(context, memory, &mark);
+        return -1;
+    }
+    double* window = memory;
+    double* segment = memory + segmentLength;
+    double* spectrum = memory + 2 * segmentLength;
+
+    // 週期性 Hann 窗
+    double windowPower = 0.0;
+    for (int i = 0; i < segmentLength; ++i) {
+        window[i] = 0.5 - 0.5 * cos(2.0 * DSP_PI * i / segmentLength);
+        windowPower += window[i] * window[i];
+    }
+
+    const int bins = segmentLength / 2 + 1;
+    const int step = segmentLength / 2;
+    memset(psd, 0, sizeof(double) * (size_t)bins);
+    int segments = 0;
+    for (int start = 0; start + segmentLength <= dataSize; start += step) {
+        double mean = 0.0;
+        for (int i = 0; i < segmentLength; ++i) {
+            mean += inputData[start + i];
+        }
+        mean /= segmentLength;
+        for (int i = 0; i < segmentLength; ++i) {
+            segment[i] = (inputData[start + i] - mean) * window[i];
+        }
+        fftRealForward(plan, segment, spectrum);
+        for (int k = 0; k < bins; ++k) {
+            psd[k] += spectrum[2 * k] * spectrum[2 * k] + spectrum[2 * k + 1] * spectrum[2 * k + 1];
+        }
+        segments++;
+    }
+
+    // 單邊密度：除直流與 Nyquist 外加倍
+    double scale = 1.0 / (sampleRate * windowPower * segments);
+    for (int k = 0; k < bins; ++k) {
+        psd[k] *= (k == 0 || k == bins - 1) ? scale : 2.0 * scale;
+    }
+    dspContextScratchRelease(context, memory, &mark);
+    return segments;
+}
+
+int welchPsdMulti(const double* const* inputData, double* const* psd, int channelCount, int dataSize, double sampleRate, int segmentLength, DspContext* context) {
+    if (inputData == NULL || psd == NULL || channelCount <= 0) {
+        return -1;
+    }
+    int segments = -1;
+    for (int channel = 0; channel < channelCount; ++channel) {
+        segments = welchPsd(inputData[channel], dataSize, sampleRate, segmentLength, psd[channel], context);
+        if (segments < 0) {
+            return -1;
+        }
+    }
+    return segments;
+}
@@ -0,0 +1,156 @@
+// fft.h
+
+#ifndef FFT_H
+#define FFT_H
+
+#include "dsp_context.h"
+
+/*
+ * Real FFT, overlap-save FIR convolution and Welch power spectral density.
+ *
+ * Transforms work on power-of-two sizes. A plan holds the bit-reversal table and the
+ * twiddle factors for one size; plans are immutable after creation, so one plan can be
+ * shared by any number of filters and threads. fftPlanCached() keeps one plan per size
+ * for the lifetime of the process (or until fftPlanCacheClear()).
+ *
+ * The FIR engine filters with the overlap-save method: each block of fftSize samples is
+ * transformed, multiplied by the kernel spectrum and transformed back, so a k-tap kernel
+ * costs O(log k) per sample instead of O(k) for direct convolution.
+ */
+
+typedef struct {
+    int size;             // real transform length N (power of two, >= 2)
+    int half;             // N / 2 complex points of the inner transform
+    int* bitReverse;      // permutation of the half-size complex transform
+    double* twiddle;      // exp(-2 pi i j / half), j < half / 2, interleaved re/im
+    double* realTwiddle;  // exp(-2 pi i k / N), k <= half / 2, interleaved re/im
+} FftPlan;
+
+/**
+ * Returns the smallest power of two >= n (at least 2), or -1 if it does not fit in int.
+ */
+int fftNextPowerOfTwo(int n);
+
+/**
+ * Creates a plan for real transforms of the given size.
+ *
+ * @return The plan, or NULL if size is not a power of two >= 2 or allocation fails.
+ */
+FftPlan* fftPlanCreate(int size);
+
+void fftPlanDestroy(FftPlan* plan);
+
+/**
+ * Returns the shared plan for size, creating it on first use. Thread-safe.
+ *
+ * @return The plan (owned by the cache), or NULL on invalid size or allocation failure.
+ */
+const FftPlan* fftPlanCached(int size);
+
+/**
+ * Destroys every cached plan. No plan returned by fftPlanCached() may be in use.
+ */
+void fftPlanCacheClear(void);
+
+/**
+ * Forward transform of plan->size real samples.
+ *
+ * @param spectrum Receives plan->size / 2 + 1 complex bins as interleaved re/im pairs
+ *                 (plan->size + 2 doubles), unnormalized: X[k] = sum x[n] e^(-2 pi i k n / N).
+ *                 May not overlap input.
+ */
+void fftRealForward(const FftPlan* plan, const double* input, double* spectrum);
+
+/**
+ * Inverse of fftRealForward(), including the 1 / N scaling, so a forward/inverse round
+ * trip returns the original samples. The imaginary parts of bins 0 and N / 2 are ignored.
+ *
+ * @param output Receives plan->size samples. May not overlap spectrum.
+ */
+void fftRealInverse(const FftPlan* plan, const double* spectrum, double* output);
+
+/**
+ * Streaming causal FIR filter, y[i] = sum_j kernel[j] * x[i - j], by overlap-save.
+ */
+typedef struct {
+    const FftPlan* plan;        // shared, from fftPlanCached()
+    int kernelLength;
+    int blockLength;            // new samples per transform: fftSize - kernelLength + 1
+    int filled;                 // new samples in the current block
+    double* kernelSpectrum;     // fftSize + 2 doubles
+    double* block;              // kernelLength - 1 history samples followed by the block
+    double* spectrum;
+    double* output;
+} FirFilter;
+
+/**
+ * Initializes a filter for the given kernel (copied).
+ *
+ * @param fftSize The transform length, a power of two > kernelLength, or 0 to pick one
+ *                (four times the kernel length, at least 64).
+ * @return 0 on success, -1 on invalid arguments or allocation failure.
+ */
+int firFilterInit(FirFilter* filter, const double* kernel, int kernelLength, int fftSize);
+
+/**
+ * Filters dataSize samples, continuing from the previous call; outputData receives one
+ * output per input sample with no added latency. inputData and outputData may be the
+ * same array. Calls that end in the middle of a block recompute that block when it is
+ * completed, so large calls are the most efficient.
+ */
+void firFilterProcess(FirFilter* filter, const double* inputData, double* outputData, int dataSize);
+
+/**
+ * Clears the history so the next sample starts a new signal (zero initial state).
+ */
+void firFilterReset(FirFilter* filter);
+
+void firFilterFree(FirFilter* filter);
+
+/**
+ * One-shot causal FIR filtering of a whole array, see FirFilter.
+ *
+ * @return 0 on success, -1 on invalid arguments or allocation failure.
+ *
+ * Example usage:
+ *     double kernel[1000];
+ *     firDesignLowPass(kernel, 1000, 2.0, 1000.0);
+ *     firConvolve(kernel, 1000, data, smoothed, dataSize);
+ */
+int firConvolve(const double* kernel, int kernelLength, const double* inputData, double* outputData, int dataSize);
+
+/**
+ * Designs a linear-phase low-pass kernel (Hamming-windowed sinc) with unit DC gain.
+ * The group delay is (kernelLength - 1) / 2 samples.
+ *
+ * @return 0 on success, -1 on invalid arguments.
+ */
+int firDesignLowPass(double* kernel, int kernelLength, double cutoffFrequency, double samplingRate);
+
+/**
+ * Welch power spectral density estimate.
+ *
+ * The signal is split into segments of segmentLength samples overlapping by half; each
+ * segment has its mean removed and a Hann window applied, and the one-sided periodograms
+ * are averaged (density scaling, units^2 / Hz, so summing psd * sampleRate / segmentLength
+ * over the bins gives the variance).
+ *
+ * @param inputData Pointer to dataSize samples.
+ * @param dataSize Number of samples, at least segmentLength.
+ * @param sampleRate Sampling rate in Hz.
+ * @param segmentLength Segment length, a power of two >= 2.
+ * @param psd Receives segmentLength / 2 + 1 values, bin k at k * sampleRate / segmentLength Hz.
+ * @param context Arena for the window and segment buffers, or NULL to use the heap.
+ * @return The number of segments averaged, or -1 on invalid arguments or allocation failure.
+ */
+int welchPsd(const double* inputData, int dataSize, double sampleRate, int segmentLength, double* psd, DspContext* context);
+
+/**
+ * welchPsd() for several channels (e.g. AX..GZ); psd[c] receives the estimate of
+ * inputData[c].
+ *
+ * @return The number of segments per channel, or -1 on error.
+ */
+int welchPsdMulti(const double* const* inputData, double* const* psd, int channelCount, int dataSize, double sampleRate, int segmentLength, DspContext* context);
+
+#endif // FFT_H
@@ -0,0 +1,177 @@
+// imu_signal.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "imu_signal.h"
+#include "dsp_kernels.h"
+
+#define IMU_GRAVITY 9.80665
+#define IMU_COLUMN_COUNT 11
+
+// splitmix64：簡單、可重現的亂數產生器
+static uint64_t nextRandom(uint64_t* state) {
+    uint64_t z = (*state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+static double nextUniform(uint64_t* state) {
+    return ((double)(nextRandom(state) >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+}
+
+// Box-Muller 常態分布
+static double nextGaussian(uint64_t* state) {
+    double u1 = nextUniform(state);
+    double u2 = nextUniform(state);
+    return sqrt(-2.0 * log(u1)) * cos(2.0 * DSP_PI * u2);
+}
+
+void imuSignalDefaultOptions(ImuSignalOptions* options) {
+    options->sampleRate = 1000.0;
+    options->seed = 1;
+    options->accelNoise = 0.01;
+    options->gyroNoise = 0.5;
+    options->strideFrequency = 1.0;
+    options->strideLength = 1.4;
+    options->stanceFraction = 0.4;
+}
+
+static int allocateSignal(ImuSignal* signal, int sampleCount, double sampleRate) {
+    memset(signal, 0, sizeof(*signal));
+    double* block = malloc(sizeof(double) * (size_t)IMU_COLUMN_COUNT * (size_t)(sampleCount > 0 ? sampleCount : 1));
+    if (block == NULL) {
+        return -1;
+    }
+    signal->sampleCount = sampleCount;
+    signal->sampleRate = sampleRate;
+    signal->timestamp = block;
+    for (int i = 0; i < 4; ++i) {
+        signal->quaternion[i] = block + (size_t)(1 + i) * (size_t)sampleCount;
+    }
+    for (int i = 0; i < 3; ++i) {
+        signal->accel[i] = block + (size_t)(5 + i) * (size_t)sampleCount;
+        signal->gyro[i] = block + (size_t)(8 + i) * (size_t)sampleCount;
+    }
+    return 0;
+}
+
+// 產生一個樣本；time 為該段內的時間（秒）
+static void fillSample(const ImuSignalOptions* options, ImuSegmentType type, double time, uint64_t* rng, ImuSignal* signal, int index) {
+    double accelWorld[3] = {0.0, 0.0, 0.0};   // m/s^2，不含重力
+    double gyro[3] = {0.0, 0.0, 0.0};         // deg/s
+    double accelNoise = options->accelNoise;
+    double gyroNoise = options->gyroNoise;
+
+    if (type == IMU_SEGMENT_WALKING) {
+        double period = 1.0 / options->strideFrequency;
+        double phase = fmod(time, period) / period;
+        if (phase >= options->stanceFraction) {
+            // 擺動期：前向加速度積分後剛好前進 strideLength 並回到零速度，垂直位移也回到 0
+            double swingTime = period * (1.0 - options->stanceFraction);
+            double u = (phase - options->stanceFraction) / (1.0 - options->stanceFraction);
+            double forward = 2.0 * DSP_PI * options->strideLength / (swingTime * swingTime);
+            accelWorld[0] = forward * sin(2.0 * DSP_PI * u);
+            accelWorld[2] = 0.5 * IMU_GRAVITY * (cos(2.0 * DSP_PI * u) - cos(4.0 * DSP_PI * u));
+            gyro[1] = 250.0 * sin(2.0 * DSP_PI * u);
+        }
+    } else if (type == IMU_SEGMENT_NOISE) {
+        accelNoise = 0.5;
+        gyroNoise = 100.0;
+    }
+
+    signal->quaternion[0][index] = 1.0;
+    signal->quaternion[1][index] = 0.0;
+    signal->quaternion[2][index] = 0.0;
+    signal->quaternion[3][index] = 0.0;
+    for (int axis = 0; axis < 3; ++axis) {
+        double gravity = axis == 2 ? 1.0 : 0.0; // 加速度計量測比力：靜止時 z 軸為 +1 g
+        signal->accel[axis][index] = accelWorld[axis] / IMU_GRAVITY + gravity + accelNoise * nextGaussian(rng);
+        signal->gyro[axis][index] = gyro[axis] + gyroNoise * nextGaussian(rng);
+    }
+}
+
+int generateImuSignal(const ImuSignalOptions* options, const ImuSegment* segments, int segmentCount, ImuSignal* signal) {
+    if (options == NULL || segments == NULL || segmentCount <= 0 || signal == NULL || options->sampleRate <= 0
+        || options->strideFrequency <= 0 || options->stanceFraction < 0 || options->stanceFraction >= 1) {
+        return -1;
+    }
+
+    long long total = 0;
+    for (int s = 0; s < segmentCount; ++s) {
+        total += (long long)llround(segments[s].seconds * options->sampleRate);
+    }
+    if (total <= 0 || total > 0x7fffffff || allocateSignal(signal, (int)total, options->sampleRate) != 0) {
+        return -1;
+    }
+
+    uint64_t rng = options->seed;
+    int index = 0;
+    for (int s = 0; s < segmentCount; ++s) {
+        int length = (int)llround(segments[s].seconds * options->sampleRate);
+        for (int i = 0; i < length; ++i, ++index) {
+            signal->timestamp[index] = index / options->sampleRate;
+            fillSample(options, segments[s].type, i / options->sampleRate, &rng, signal, index);
+        }
+    }
+    return 0;
+}
+
+int generateImuBenchmarkSignal(const ImuSignalOptions* options, int sampleCount, ImuSignal* signal) {
+    if (options == NULL || signal == NULL || sampleCount <= 0 || options->sampleRate <= 0) {
+        return -1;
+    }
+    static const ImuSegment cycle[] = {
+        {IMU_SEGMENT_STATIONARY, 2.0},
+        {IMU_SEGMENT_WALKING, 6.0},
+        {IMU_SEGMENT_NOISE, 2.0},
+    };
+    const int cycleLength = (int)(sizeof(cycle) / sizeof(cycle[0]));
+
+    if (allocateSignal(signal, sampleCount, options->sampleRate) != 0) {
+        return -1;
+    }
+    uint64_t rng = options->seed;
+    int segment = 0;
+    int segmentStart = 0;
+    for (int index = 0; index < sampleCount; ++index) {
+        int segmentLength = (int)llround(cycle[segment].seconds * options->sampleRate);
+        if (index - segmentStart >= segmentLength) {
+            segment = (segment + 1) % cycleLength;
+            segmentStart = index;
+        }
+        signal->timestamp[index] = index / options->sampleRate;
+        fillSample(options, cycle[segment].type, (index - segmentStart) / options->sampleRate, &rng, signal, index);
+    }
+    return 0;
+}
+
+int writeImuSignalCsv(const ImuSignal* signal, const char* path) {
+    if (signal == NULL || path == NULL) {
+        return -1;
+    }
+    FILE* file = fopen(path, "w");
+    if (file == NULL) {
+        perror(path);
+        return -1;
+    }
+    for (int i = 0; i < signal->sampleCount; ++i) {
+        fprintf(file, "%.6f,%.8f,%.8f,%.8f,%.8f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f\n",
+                signal->timestamp[i],
+                signal->quaternion[0][i], signal->quaternion[1][i], signal->quaternion[2][i], signal->quaternion[3][i],
+                signal->accel[0][i], signal->accel[1][i], signal->accel[2][i],
+                signal->gyro[0][i], signal->gyro[1][i], signal->gyro[2][i]);
+    }
+    return fclose(file) == 0 ? 0 : -1;
+}
+
+void freeImuSignal(ImuSignal* signal) {
+    if (signal == NULL) {
+        return;
+    }
+    free(signal->timestamp); // 所有欄位共用同一塊記憶體
+    memset(signal, 0, sizeof(*signal));
+}
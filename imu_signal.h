@@ -0,0 +1,77 @@
+// imu_signal.h
+
+#ifndef IMU_SIGNAL_H
+#define IMU_SIGNAL_H
+
+/*
+ * Deterministic synthetic 6-axis IMU recordings for benchmarks and experiments.
+ *
+ * The generated columns follow demo.csv: timestamp (s), quaternion w/x/y/z,
+ * accelerometer AX/AY/AZ (g) and gyroscope GX/GY/GZ (deg/s). The body frame is kept
+ * aligned with the world frame (identity quaternion, z up), so a resting sensor reads
+ * +1 g on AZ.
+ */
+
+typedef enum {
+    IMU_SEGMENT_STATIONARY,   // sensor at rest: gravity plus sensor noise
+    IMU_SEGMENT_WALKING,      // foot-mounted gait: stance phases at rest, swing phases moving
+    IMU_SEGMENT_NOISE         // large random vibration, no structure
+} ImuSegmentType;
+
+typedef struct {
+    ImuSegmentType type;
+    double seconds;
+} ImuSegment;
+
+typedef struct {
+    double sampleRate;            // Hz
+    unsigned long long seed;      // same seed and segments give bit-identical output
+    double accelNoise;            // accelerometer noise standard deviation (g)
+    double gyroNoise;             // gyroscope noise standard deviation (deg/s)
+    double strideFrequency;       // strides per second while walking
+    double strideLength;          // metres travelled per stride
+    double stanceFraction;        // fraction of each stride the foot is flat on the ground
+} ImuSignalOptions;
+
+typedef struct {
+    int sampleCount;
+    double sampleRate;
+    double* timestamp;
+    double* quaternion[4];        // w, x, y, z
+    double* accel[3];             // AX, AY, AZ
+    double* gyro[3];              // GX, GY, GZ
+} ImuSignal;
+
+/**
+ * Fills options with defaults: 1 kHz, seed 1, 0.01 g / 0.5 deg/s noise, 1 stride/s,
+ * 1.4 m strides, 40 % stance.
+ */
+void imuSignalDefaultOptions(ImuSignalOptions* options);
+
+/**
+ * Generates a recording made of consecutive segments.
+ *
+ * In walking segments every stride has a stance phase (zero velocity, suitable for ZUPT)
+ * followed by a swing phase whose forward acceleration integrates to exactly
+ * strideLength metres and whose vertical acceleration returns the foot to the ground.
+ *
+ * @return 0 on success, -1 on invalid arguments or allocation failure.
+ */
+int generateImuSignal(const ImuSignalOptions* options, const ImuSegment* segments, int segmentCount, ImuSignal* signal);
+
+/**
+ * Generates sampleCount samples cycling through stationary, walking and noise segments
+ * (2 s, 6 s and 2 s), the mix used by dsp_bench.
+ */
+int generateImuBenchmarkSignal(const ImuSignalOptions* options, int sampleCount, ImuSignal* signal);
+
+/**
+ * Writes the recording as CSV in the demo.csv column layout.
+ *
+ * @return 0 on success, -1 on I/O error.
+ */
+int writeImuSignalCsv(const ImuSignal* signal, const char* path);
+
+void freeImuSignal(ImuSignal* signal);
+
+#endif // IMU_SIGNAL_H
@@ -0,0 +1,241 @@
+// interval_index.c
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "interval_index.h"
+
+int intervalIndexInit(IntervalIndex* index, double sampleRate) {
+    if (index == NULL || !(sampleRate > 0)) {
+        return -1;
+    }
+    memset(index, 0, sizeof(*index));
+    index->sampleRate = sampleRate;
+    return 0;
+}
+
+void freeIntervalIndex(IntervalIndex* index) {
+    if (index == NULL) {
+        return;
+    }
+    free(index->intervals);
+    index->intervals = NULL;
+    index->count = 0;
+    index->capacity = 0;
+    index->sampleCount = 0;
+}
+
+static int appendInterval(IntervalIndex* index, int start, int end, IntervalState state) {
+    if (end <= start) {
+        return 0;
+    }
+    if (index->count == index->capacity) {
+        int newCapacity = index->capacity > 0 ? index->capacity * 2 : 64;
+        MotionInterval* grown = realloc(index->intervals, sizeof(MotionInterval) * (size_t)newCapacity);
+        if (grown == NULL) {
+            return -1;
+        }
+        index->intervals = grown;
+        index->capacity = newCapacity;
+    }
+    index->intervals[index->count].start = start;
+    index->intervals[index->count].end = end;
+    index->intervals[index->count].state = state;
+    index->count++;
+    index->sampleCount = end;
+    return 0;
+}
+
+int intervalSegmenterInit(IntervalSegmenter* segmenter, const SegmentationOptions* options, IntervalIndex* index) {
+    if (segmenter == NULL || options == NULL || index == NULL || options->exitThreshold > options->enterThreshold
+        || options->minMotionSamples <= 0 || options->minStationarySamples <= 0) {
+        return -1;
+    }
+    memset(segmenter, 0, sizeof(*segmenter));
+    segmenter->options = *options;
+    segmenter->index = index;
+    segmenter->pendingStart = -1;
+    index->count = 0;
+    index->sampleCount = 0;
+    return 0;
+}
+
+int intervalSegmenterPush(IntervalSegmenter* segmenter, double activity) {
+    int i = segmenter->position++;
+    if (i == 0) {
+        segmenter->state = activity > segmenter->options.enterThreshold ? INTERVAL_MOTION : INTERVAL_STATIONARY;
+        return 0;
+    }
+
+    // 遲滯：靜止時須超過 enterThreshold 才算運動，運動時須低於 exitThreshold 才算靜止
+    int opposite = segmenter->state == INTERVAL_STATIONARY
+        ? activity > segmenter->options.enterThreshold
+        : activity < segmenter->options.exitThreshold;
+    if (!opposite) {
+        segmenter->pendingStart = -1;
+        return 0;
+    }
+    if (segmenter->pendingStart < 0) {
+        segmenter->pendingStart = i;
+    }
+    int required = segmenter->state == INTERVAL_STATIONARY
+        ? segmenter->options.minMotionSamples
+        : segmenter->options.minStationarySamples;
+    if (i - segmenter->pendingStart + 1 < required) {
+        return 0;
+    }
+
+    // 新狀態持續足夠久：在該段開始處切換
+    if (appendInterval(segmenter->index, segmenter->intervalStart, segmenter->pendingStart, segmenter->state) != 0) {
+        return -1;
+    }
+    segmenter->intervalStart = segmenter->pendingStart;
+    segmenter->state = segmenter->state == INTERVAL_STATIONARY ? INTERVAL_MOTION : INTERVAL_STATIONARY;
+    segmenter->pendingStart = -1;
+    return 0;
+}
+
+int intervalSegmenterFinish(IntervalSegmenter* segmenter) {
+    if (segmenter == NULL || segmenter->index == NULL) {
+        return -1;
+    }
+    return appendInterval(segmenter->index, segmenter->intervalStart, segmenter->position, segmenter->state);
+}
+
+int buildIntervalIndex(const double* activity, int dataSize, double sampleRate, const SegmentationOptions* options, IntervalIndex* index) {
+    if (activity == NULL || dataSize < 0 || intervalIndexInit(index, sampleRate) != 0) {
+        return -1;
+    }
+    IntervalSegmenter segmenter;
+    if (intervalSegmenterInit(&segmenter, options, index) != 0) {
+        return -1;
+    }
+    for (int i = 0; i < dataSize; ++i) {
+        if (intervalSegmenterPush(&segmenter, fabs(activity[i])) != 0) {
+            freeIntervalIndex(index);
+            return -1;
+        }
+    }
+    if (intervalSegmenterFinish(&segmenter) != 0) {
+        freeIntervalIndex(index);
+        return -1;
+    }
+    return 0;
+}
+
+int buildMovementIndex(const double* inputData, int dataSize, double samplingRate, const SegmentationOptions* options, IntervalIndex* index) {
+    if (inputData == NULL || dataSize < 0 || intervalIndexInit(index, samplingRate) != 0) {
+        return -1;
+    }
+    IntervalSegmenter segmenter;
+    if (intervalSegmenterInit(&segmenter, options, index) != 0) {
+        return -1;
+    }
+
+    double dt = 1.0 / samplingRate;
+    double dtSquared = dt * dt;
+    int failed = 0;
+    for (int i = 0; i < dataSize && !failed; ++i) {
+        double activity = 0.0; // 端點無法計算二階微分
+        if (i > 0 && i < dataSize - 1) {
+            activity = fabs((inputData[i + 1] - 2 * inputData[i] + inputData[i - 1]) / dtSquared);
+        }
+        failed = intervalSegmenterPush(&segmenter, activity) != 0;
+    }
+    if (failed || intervalSegmenterFinish(&segmenter) != 0) {
+        freeIntervalIndex(index);
+        return -1;
+    }
+    return 0;
+}
+
+int intervalIndexFind(const IntervalIndex* index, int sample) {
+    if (index == NULL || index->count == 0 || sample < 0 || sample >= index->sampleCount) {
+        return -1;
+    }
+    // 找出最後一個 start <= sample 的區間
+    int low = 0;
+    int high = index->count - 1;
+    while (low < high) {
+        int middle = low + (high - low + 1) / 2;
+        if (index->intervals[middle].start <= sample) {
+            low = middle;
+        } else {
+            high = middle - 1;
+        }
+    }
+    return low;
+}
+
+static int sampleAtTime(const IntervalIndex* index, double time) {
+    double sample = floor(time * index->sampleRate);
+    if (!(sample >= 0)) {
+        return -1;
+    }
+    return sample >= index->sampleCount ? index->sampleCount : (int)sample;
+}
+
+int intervalIndexIsStationary(const IntervalIndex* index, double time) {
+    if (index == NULL) {
+        return -1;
+    }
+    int position = intervalIndexFind(index, sampleAtTime(index, time));
+    if (position < 0) {
+        return -1;
+    }
+    return index->intervals[position].state == INTERVAL_STATIONARY;
+}
+
+int intervalIndexOverlapping(const IntervalIndex* index, double startTime, double endTime, int* first) {
+    if (first != NULL) {
+        *first = 0;
+    }
+    if (index == NULL || index->count == 0 || endTime < startTime) {
+        return 0;
+    }
+    int startSample = sampleAtTime(index, startTime);
+    int endSample = sampleAtTime(index, endTime);
+    if (endSample < 0 || startSample >= index->sampleCount) {
+        return 0;
+    }
+    int firstPosition = intervalIndexFind(index, startSample < 0 ? 0 : startSample);
+    int lastPosition = intervalIndexFind(index, endSample >= index->sampleCount ? index->sampleCount - 1 : endSample);
+    if (first != NULL) {
+        *first = firstPosition;
+    }
+    return lastPosition - firstPosition + 1;
+}
+
+int applyZuptIntervals(double* velocityData, int dataSize, const IntervalIndex* index) {
+    if (velocityData == NULL || dataSize < 0 || index == NULL) {
+        return -1;
+    }
+    int applied = 0;
+    for (int i = 0; i < index->count; ++i) {
+        const MotionInterval* interval = &index->intervals[i];
+        if (interval->state != INTERVAL_STATIONARY || interval->start >= dataSize) {
+            continue;
+        }
+        int end = interval->end < dataSize ? interval->end : dataSize;
+        memset(velocityData + interval->start, 0, sizeof(double) * (size_t)(end - interval->start));
+        applied++;
+    }
+    return applied;
+}
+
+int intervalIndexWriteGnuplot(FILE* gnuplotPipe, const IntervalIndex* index, IntervalState state) {
+    if (gnuplotPipe == NULL || index == NULL) {
+        return 0;
+    }
+    int written = 0;
+    for (int i = 0; i < index->count; ++i) {
+        const MotionInterval* interval = &index->intervals[i];
+        if (interval->state != state) {
+            continue;
+        }
+        fprintf(gnuplotPipe, "set object rect from first %d, graph 0 to first %d, graph 1 behind fillcolor rgb '#e8e8f8' fillstyle solid noborder\n",
+                interval->start, interval->end - 1);
+        written++;
+    }
+    return written;
+}
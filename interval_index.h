@@ -0,0 +1,151 @@
+// interval_index.h
+
+#ifndef INTERVAL_INDEX_H
+#define INTERVAL_INDEX_H
+
+#include <stdio.h>
+
+/*
+ * Compact segmentation of a recording into alternating stationary and motion intervals.
+ *
+ * Instead of a dense per-sample mask (detectMovement() writes one double per sample),
+ * a segmentation pass produces a sorted list of [start, end) sample ranges that cover
+ * the whole recording, so a 10M-sample walk with a few hundred stance phases needs a
+ * few kilobytes. Lookups by sample or time and range queries are binary searches.
+ *
+ * Segmentation uses two thresholds (hysteresis) on a per-sample activity measure and
+ * a minimum duration for each state, so noise around a single threshold does not split
+ * intervals. The segmenter is pushed one sample at a time and keeps O(1) state, so any
+ * activity measure can be fed without materializing it.
+ */
+
+typedef enum {
+    INTERVAL_STATIONARY = 0,
+    INTERVAL_MOTION = 1
+} IntervalState;
+
+typedef struct {
+    int start;              // first sample
+    int end;                // one past the last sample
+    IntervalState state;
+} MotionInterval;
+
+typedef struct {
+    MotionInterval* intervals;  // sorted, contiguous, alternating states
+    int count;
+    int capacity;
+    int sampleCount;            // samples covered: intervals[count - 1].end
+    double sampleRate;          // Hz, used by the time-based queries
+} IntervalIndex;
+
+typedef struct {
+    double enterThreshold;      // activity above this starts motion
+    double exitThreshold;       // activity below this ends motion (<= enterThreshold)
+    int minMotionSamples;       // a motion run must last this long to open an interval
+    int minStationarySamples;   // likewise for stationary runs
+} SegmentationOptions;
+
+/**
+ * Streaming segmenter writing into an IntervalIndex.
+ */
+typedef struct {
+    SegmentationOptions options;
+    IntervalIndex* index;
+    IntervalState state;
+    int intervalStart;
+    int pendingStart;           // first sample of a run in the opposite state, -1 if none
+    int position;               // samples pushed so far
+} IntervalSegmenter;
+
+/**
+ * Initializes an empty index.
+ *
+ * @return 0 on success, -1 if sampleRate is not positive.
+ */
+int intervalIndexInit(IntervalIndex* index, double sampleRate);
+
+void freeIntervalIndex(IntervalIndex* index);
+
+/**
+ * Starts segmenting into index, which is cleared first.
+ *
+ * @return 0 on success, -1 on invalid options (exitThreshold > enterThreshold or
+ *         non-positive minimum durations).
+ */
+int intervalSegmenterInit(IntervalSegmenter* segmenter, const SegmentationOptions* options, IntervalIndex* index);
+
+/**
+ * Pushes the activity of the next sample. The first sample decides the initial state;
+ * afterwards the state flips once the opposite condition has held for the minimum
+ * duration of the new state, and the new interval starts where that run began.
+ *
+ * @return 0 on success, -1 on allocation failure.
+ */
+int intervalSegmenterPush(IntervalSegmenter* segmenter, double activity);
+
+/**
+ * Closes the last interval. Every interval except the first is at least as long as
+ * the minimum duration of its state.
+ *
+ * @return 0 on success, -1 on allocation failure.
+ */
+int intervalSegmenterFinish(IntervalSegmenter* segmenter);
+
+/**
+ * Segments a precomputed activity array (the absolute value of each sample is used).
+ *
+ * @return 0 on success, -1 on invalid arguments or allocation failure.
+ */
+int buildIntervalIndex(const double* activity, int dataSize, double sampleRate, const SegmentationOptions* options, IntervalIndex* index);
+
+/**
+ * Segments a signal by the absolute second derivative used by detectMovement(), computed
+ * on the fly; the first and last samples have zero activity.
+ *
+ * Example usage:
+ *     SegmentationOptions options = {0.5, 0.3, 5, 10};
+ *     IntervalIndex index;
+ *     if (buildMovementIndex(position, dataSize, 50.0, &options, &index) == 0) {
+ *         printf("%d intervals\n", index.count);
+ *         freeIntervalIndex(&index);
+ *     }
+ */
+int buildMovementIndex(const double* inputData, int dataSize, double samplingRate, const SegmentationOptions* options, IntervalIndex* index);
+
+/**
+ * Returns the position in index->intervals of the interval containing sample, or -1 if
+ * sample is outside the recording. O(log count).
+ */
+int intervalIndexFind(const IntervalIndex* index, int sample);
+
+/**
+ * Returns 1 if the sample at time seconds (sample floor(time * sampleRate)) lies in a
+ * stationary interval, 0 if it lies in a motion interval and -1 if it is out of range.
+ */
+int intervalIndexIsStationary(const IntervalIndex* index, double time);
+
+/**
+ * Finds the intervals overlapping the time range [startTime, endTime] (seconds).
+ *
+ * @param first Receives the position of the first overlapping interval.
+ * @return The number of overlapping intervals, which are intervals[*first] onwards;
+ *         0 if the range misses the recording.
+ */
+int intervalIndexOverlapping(const IntervalIndex* index, double startTime, double endTime, int* first);
+
+/**
+ * ZUPT driven by the index: zeroes velocityData over every stationary interval.
+ *
+ * @return The number of stationary intervals applied, or -1 on invalid arguments.
+ */
+int applyZuptIntervals(double* velocityData, int dataSize, const IntervalIndex* index);
+
+/**
+ * Emits gnuplot commands that shade every interval in the given state as a background
+ * rectangle (x in sample units, full plot height); they apply to all following plots.
+ *
+ * @return The number of rectangles written.
+ */
+int intervalIndexWriteGnuplot(FILE* gnuplotPipe, const IntervalIndex* index, IntervalState state);
+
+#endif // INTERVAL_INDEX_H
@@ -0,0 +1,345 @@
+// live_stream.c
+#include <errno.h>
+#include <math.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "live_stream.h"
+#include "csv_loader.h"
+#include "dsp_context.h"
+#include "dsp_stats.h"
+#include "pipeline.h"
+#include "spsc_ring.h"
+
+#define LIVE_READ_BUFFER (64 * 1024)
+#define LIVE_DEFAULT_RING 8192
+#define LIVE_FIRST_AXIS_COLUMN 5     // AX, AY, AZ, GX, GY, GZ 位於第 5 到 10 列
+
+typedef struct {
+    double timestamp;
+    double values[LIVE_STREAM_AXES];
+    double arrival;                  // 讀入該行的時間（CLOCK_MONOTONIC 秒）
+} LiveSample;
+
+typedef struct {
+    SpscRing ring;
+    int fd;
+    // 以下只由讀取執行緒寫入，join 之後才讀取
+    long long linesRejected;
+    long long bytesRead;
+    long long producerStalls;
+    int readFailed;
+} LiveStream;
+
+static double monotonicSeconds(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+static void sleepNanoseconds(long nanoseconds) {
+    struct timespec delay = {0, nanoseconds};
+    nanosleep(&delay, NULL);
+}
+
+int liveStreamOpen(const char* source) {
+    if (source == NULL) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (strcmp(source, "-") == 0) {
+        return STDIN_FILENO;
+    }
+    if (strncmp(source, "unix:", 5) != 0) {
+        return open(source, O_RDONLY); // 一般檔案或 FIFO（等待寫入端開啟）
+    }
+
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    const char* path = source + 5;
+    if (strlen(path) >= sizeof(address.sun_path)) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    strcpy(address.sun_path, path);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    if (connect(fd, (struct sockaddr*)&address, sizeof(address)) != 0) {
+        int saved = errno;
+        close(fd);
+        errno = saved;
+        return -1;
+    }
+    return fd;
+}
+
+// 解析一行：0 表示成功，1 表示空行，-1 表示缺少或無效的欄位
+static int parseLine(const char* line, const char* lineEnd, double arrival, LiveSample* sample) {
+    if (lineEnd > line && lineEnd[-1] == '\r') {
+        lineEnd--;
+    }
+    if (lineEnd == line) {
+        return 1;
+    }
+    const char* field = line;
+    for (int column = 0; column < LIVE_FIRST_AXIS_COLUMN + LIVE_STREAM_AXES; ++column) {
+        const char* fieldEnd = memchr(field, ',', (size_t)(lineEnd - field));
+        if (fieldEnd == NULL) {
+            fieldEnd = lineEnd;
+        }
+        if (column == 0 && parseCsvDouble(field, fieldEnd, &sample->timestamp) != 0) {
+            return -1;
+        }
+        if (column >= LIVE_FIRST_AXIS_COLUMN
+            && parseCsvDouble(field, fieldEnd, &sample->values[column - LIVE_FIRST_AXIS_COLUMN]) != 0) {
+            return -1;
+        }
+        if (fieldEnd == lineEnd && column < LIVE_FIRST_AXIS_COLUMN + LIVE_STREAM_AXES - 1) {
+            return -1; // 欄位不足
+        }
+        field = fieldEnd + 1;
+    }
+    sample->arrival = arrival;
+    return 0;
+}
+
+// 環形緩衝區滿時等待消費者，而不是配置更多記憶體
+static void pushAll(LiveStream* stream, const LiveSample* samples, int count) {
+    size_t pushed = 0;
+    while (pushed < (size_t)count) {
+        size_t n = spscRingPush(&stream->ring, samples + pushed, (size_t)count - pushed);
+        if (n == 0) {
+            stream->producerStalls++;
+            sleepNanoseconds(50000);
+        }
+        pushed += n;
+    }
+}
+
+static void* readerThread(void* argument) {
+    LiveStream* stream = argument;
+    char buffer[LIVE_READ_BUFFER];
+    LiveSample pending[LIVE_STREAM_BLOCK];
+    int pendingCount = 0;
+    size_t length = 0;
+    int discarding = 0;   // 正在略過超長行的剩餘部分
+
+    for (;;) {
+        ssize_t n = read(stream->fd, buffer + length, sizeof(buffer) - length);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0) {
+            stream->readFailed = 1;
+            break;
+        }
+        double arrival = monotonicSeconds();
+        if (n == 0) {
+            // 結尾沒有換行的最後一行
+            if (discarding) {
+                length = 0;
+            }
+            if (length > 0 && parseLine(buffer, buffer + length, arrival, &pending[0]) == 0) {
+                pushAll(stream, pending, 1);
+            } else if (length > 0) {
+                stream->linesRejected++;
+            }
+            break;
+        }
+        stream->bytesRead += n;
+        length += (size_t)n;
+
+        char* p = buffer;
+        char* end = buffer + length;
+        char* lineEnd;
+        if (discarding) {
+            // 超長行已計為一次拒絕，其餘部分到下一個換行為止都直接丟棄
+            lineEnd = memchr(p, '\n', (size_t)(end - p));
+            if (lineEnd == NULL) {
+                length = 0;
+                continue;
+            }
+            p = lineEnd + 1;
+            discarding = 0;
+        }
+        while ((lineEnd = memchr(p, '\n', (size_t)(end - p))) != NULL) {
+            int status = parseLine(p, lineEnd, arrival, &pending[pendingCount]);
+            if (status == 0 && ++pendingCount == LIVE_STREAM_BLOCK) {
+                pushAll(stream, pending, pendingCount);
+                pendingCount = 0;
+            } else if (status < 0) {
+                stream->linesRejected++;
+            }
+            p = lineEnd + 1;
+        }
+        // 每次讀取後立即交出已解析的樣本，延遲不受區塊大小影響
+        pushAll(stream, pending, pendingCount);
+        pendingCount = 0;
+
+        length = (size_t)(end - p);
+        memmove(buffer, p, length);
+        if (length == sizeof(buffer)) {
+            stream->linesRejected++; // 超過緩衝區的行整行丟棄
+            length = 0;
+            discarding = 1;
+        }
+    }
+    spscRingClose(&stream->ring);
+    return NULL;
+}
+
+static void recordLatency(LiveStreamReport* report, double latency) {
+    double nanoseconds = latency * 1e9;
+    int bucket = nanoseconds >= 1.0 ? (int)log2(nanoseconds) : 0;
+    if (bucket >= LIVE_STREAM_LATENCY_BUCKETS) {
+        bucket = LIVE_STREAM_LATENCY_BUCKETS - 1;
+    }
+    report->latencyHistogram[bucket]++;
+    report->latencyMean += latency; // 結束時再除以樣本數
+    if (latency > report->latencyMax) {
+        report->latencyMax = latency;
+    }
+}
+
+static double latencyPercentile(const LiveStreamReport* report, double fraction) {
+    long long target = (long long)ceil(fraction * (double)report->samplesProcessed);
+    long long cumulative = 0;
+    for (int b = 0; b < LIVE_STREAM_LATENCY_BUCKETS; ++b) {
+        cumulative += report->latencyHistogram[b];
+        if (cumulative >= target && cumulative > 0) {
+            double bound = ldexp(1e-9, b + 1);
+            return bound < report->latencyMax ? bound : report->latencyMax;
+        }
+    }
+    return 0.0;
+}
+
+static void writeRows(FILE* output, const LiveSample* block, double (*filtered)[LIVE_STREAM_BLOCK], int count) {
+    for (int i = 0; i < count; ++i) {
+        fprintf(output, "%.6f", block[i].timestamp);
+        for (int axis = 0; axis < LIVE_STREAM_AXES; ++axis) {
+            fprintf(output, ",%.17g", filtered[axis][i]); // 完整精度，可與批次結果逐位比較
+        }
+        fputc('\n', output);
+    }
+    fflush(output);
+}
+
+int runLiveStream(const LiveStreamOptions* options, LiveStreamReport* report) {
+    if (options == NULL || report == NULL || options->windowSize <= 0) {
+        return -1;
+    }
+    memset(report, 0, sizeof(*report));
+    double start = monotonicSeconds();
+
+    LiveStream stream;
+    memset(&stream, 0, sizeof(stream));
+    stream.fd = liveStreamOpen(options->source);
+    if (stream.fd < 0) {
+        perror(options->source);
+        return -1;
+    }
+    int ringCapacity = options->ringCapacity > 0 ? options->ringCapacity : LIVE_DEFAULT_RING;
+    if (spscRingInit(&stream.ring, sizeof(LiveSample), (size_t)ringCapacity) != 0) {
+        if (stream.fd != STDIN_FILENO) {
+            close(stream.fd);
+        }
+        return -1;
+    }
+
+    // 每個軸一條處理鏈，緩衝區都取自同一個 context
+    DspContext context;
+    Pipeline pipelines[LIVE_STREAM_AXES];
+    int result = dspContextInit(&context, 0);
+    int initialized = 0;
+    while (result == 0 && initialized < LIVE_STREAM_AXES) {
+        // 只計入初始化成功的處理鏈，清理時才不會釋放未初始化的結構
+        Pipeline* pipeline = &pipelines[initialized];
+        if (pipelineInit(pipeline, &context) != 0) {
+            result = -1;
+            break;
+        }
+        initialized++;
+        if (pipelineAddMovingAverage(pipeline, options->windowSize) < 0) {
+            result = -1;
+        }
+    }
+    pthread_t reader;
+    if (result == 0 && pthread_create(&reader, NULL, readerThread, &stream) != 0) {
+        result = -1;
+    }
+
+    if (result == 0) {
+        LiveSample block[LIVE_STREAM_BLOCK];
+        double axisData[LIVE_STREAM_BLOCK];
+        double filtered[LIVE_STREAM_AXES][LIVE_STREAM_BLOCK];
+        int idle = 0;
+        for (;;) {
+            int count = (int)spscRingPop(&stream.ring, block, LIVE_STREAM_BLOCK);
+            if (count == 0) {
+                if (spscRingDrained(&stream.ring)) {
+                    break;
+                }
+                // 先讓出 CPU，等待較久後改為短暫休眠
+                if (++idle < 64) {
+                    sched_yield();
+                } else {
+                    sleepNanoseconds(20000);
+                }
+                continue;
+            }
+            idle = 0;
+            for (int axis = 0; axis < LIVE_STREAM_AXES; ++axis) {
+                for (int i = 0; i < count; ++i) {
+                    axisData[i] = block[i].values[axis];
+                }
+                pipelinePush(&pipelines[axis], axisData, filtered[axis], count);
+            }
+            if (options->output != NULL) {
+                writeRows(options->output, block, filtered, count);
+            }
+            double now = monotonicSeconds();
+            for (int i = 0; i < count; ++i) {
+                recordLatency(report, now - block[i].arrival);
+            }
+            report->samplesProcessed += count;
+        }
+        pthread_join(reader, NULL);
+        if (stream.readFailed) {
+            perror("Error reading stream");
+            result = -1;
+        }
+    }
+
+    for (int axis = 0; axis < initialized; ++axis) {
+        pipelineFree(&pipelines[axis]);
+    }
+    dspContextFree(&context);
+    spscRingFree(&stream.ring);
+    if (stream.fd != STDIN_FILENO) {
+        close(stream.fd);
+    }
+
+    report->linesRejected = stream.linesRejected;
+    report->bytesRead = stream.bytesRead;
+    report->producerStalls = stream.producerStalls;
+    report->seconds = monotonicSeconds() - start;
+    if (report->samplesProcessed > 0) {
+        report->latencyMean /= (double)report->samplesProcessed;
+        report->latencyP50 = latencyPercentile(report, 0.50);
+        report->latencyP99 = latencyPercentile(report, 0.99);
+    }
+    DSP_STATS_ADD(DSP_COUNTER_BYTES_READ, stream.bytesRead);
+    DSP_STATS_ADD(DSP_COUNTER_ROWS_PARSED, report->samplesProcessed);
+    return result;
+}
@@ -0,0 +1,70 @@
+// live_stream.h
+
+#ifndef LIVE_STREAM_H
+#define LIVE_STREAM_H
+
+#include <stdio.h>
+
+/*
+ * Live ingestion: runs the filter pipeline on an IMU stream as it arrives.
+ *
+ * A reader thread reads the source (stdin, a FIFO or a UNIX stream socket) in chunks,
+ * parses every complete line (demo.csv layout: timestamp in column 0, AX..GZ in columns
+ * 5 to 10), stamps it with its arrival time and pushes it into a lock-free SPSC ring.
+ * The calling thread pops whatever has arrived, up to LIVE_STREAM_BLOCK samples at a
+ * time, pushes each axis through its own Pipeline and writes the filtered rows
+ * immediately. Memory is fixed by the ring capacity and the read buffer, however long
+ * the stream runs: when the consumer falls behind the reader stops reading and the
+ * sender is throttled by the pipe or socket.
+ *
+ * Latency is measured per sample from the moment its line was read to the moment its
+ * filtered row was written.
+ */
+
+#define LIVE_STREAM_AXES 6
+#define LIVE_STREAM_BLOCK 256             // samples popped per DSP iteration at most
+#define LIVE_STREAM_LATENCY_BUCKETS 40    // log2 nanosecond histogram, up to ~18 minutes
+
+typedef struct {
+    const char* source;        // "-" for stdin, "unix:<path>" for a socket, else a file or FIFO path
+    int windowSize;            // moving-average window applied to every axis
+    int ringCapacity;          // samples buffered between the threads, 0 = 8192
+    FILE* output;              // receives "timestamp,AX,...,GZ" per sample (%.17g values); NULL discards
+} LiveStreamOptions;
+
+typedef struct {
+    long long samplesProcessed;
+    long long linesRejected;   // lines without a numeric timestamp and six axis values
+    long long bytesRead;
+    long long producerStalls;  // times the reader found the ring full
+    double seconds;            // wall-clock time from start to end of stream
+    double latencyMean;        // seconds, read -> written
+    double latencyMax;
+    double latencyP50;         // upper bound of the histogram bucket (at most latencyMax)
+    double latencyP99;
+    long long latencyHistogram[LIVE_STREAM_LATENCY_BUCKETS]; // bucket b: [2^b, 2^(b+1)) ns
+} LiveStreamReport;
+
+/**
+ * Opens a stream source for reading.
+ *
+ * @return A file descriptor, or -1 with errno set.
+ */
+int liveStreamOpen(const char* source);
+
+/**
+ * Processes options->source until end of stream.
+ *
+ * @return 0 on success, -1 if the source cannot be opened, the threads cannot be started
+ *         or a read fails.
+ *
+ * Example usage:
+ *     LiveStreamOptions options = {"unix:/tmp/imu.sock", 3, 0, stdout};
+ *     LiveStreamReport report;
+ *     if (runLiveStream(&options, &report) == 0) {
+ *         fprintf(stderr, "p99 latency %.3f ms\n", report.latencyP99 * 1e3);
+ *     }
+ */
+int runLiveStream(const LiveStreamOptions* options, LiveStreamReport* report);
+
+#endif // LIVE_STREAM_H
@@ -2,73 +2,371 @@
 // main.c
 #include <stdio.h>               // 為 printf 函數
 #include <stdlib.h>
-#include <string.h>  // Include this for strtok function
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
 
 #include "helloworld.h"
 #include "data_processing.h"     // 為 calculateMovingAverage 函數，假設它在這個頭文件中聲明
+#include "csv_loader.h"
+#include "dsp_context.h"
+#include "pipeline.h"
+#include "batch_runner.h"
+#include "live_stream.h"
+#include "column_file.h"
+#include "dsp_stats.h"
+#include "pedestrian.h"
+#include "interval_index.h"
+#include "fft.h"
+#include "downsample.h"
 
 
-#include <stdio.h>
-#include <stdlib.h>
+void printUsage(char *programName) {
+    printf("Usage: %s <path_to_csv>\n", programName);
+    printf("       %s --batch <directory_or_list> [-j <threads>] [--output <directory>]\n", programName);
+    printf("       %s --live <source>\n", programName);
+    printf("Options:\n");
+    printf("  -h               Display this help message and exit\n");
+    printf("  <path_to_csv>    Path to the CSV file to be processed\n");
+    printf("  --batch <path>   Process every *.csv in a directory, or every path listed\n");
+    printf("                   one per line in a file, on a thread pool (no plotting)\n");
+    printf("  -j <threads>     Worker threads for --batch (default: all CPUs)\n");
+    printf("  --output <dir>   Directory for the --batch results (default: next to each input)\n");
+    printf("  --live <source>  Filter a live stream from stdin (-), a FIFO or a UNIX socket\n");
+    printf("                   (unix:<path>) and write the filtered rows to stdout\n");
+    printf("  --stats          Print per-stage timings and counters as JSON on exit\n");
+    printf("  --psd <path>     Write the Welch power spectral density of the six axes as CSV\n");
+    printf("  --plot-points <n>  Points per plotted line (default: 2000, 0 = every sample)\n");
+    printf("  --downsample <mode>  Plot decimation: minmax (default) or lttb\n");
+}
 
-int readCsvData(const char* filename, double* data, int maxDataSize, int targetColumn) {
-    FILE *file = fopen(filename, "r");
-    if (!file) {
-        perror("Unable to open file!");
-        return -1;  // 返回错误代码
-    }
-
-    char buffer[1024];
-    int totalRows = 0;
-    int index = 0;
-
-    // 读取文件并提取目标列的数据
-    while (fgets(buffer, sizeof(buffer), file)) {
-        int currentColumn = 0;
-        char* token = strtok(buffer, ",");
-        while (token != NULL) {
-            if (currentColumn == targetColumn && index < maxDataSize) {
-                data[index++] = atof(token);
-            }
-            token = strtok(NULL, ",");
-            currentColumn++;
+static int runBatchMode(const char* inputPath, const char* outputDirectory, int threadCount, int windowSize) {
+    char** files = NULL;
+    int fileCount = 0;
+    if (collectBatchInputs(inputPath, &files, &fileCount) != 0) {
+        fprintf(stderr, "Failed to read batch input %s\n", inputPath);
+        return 1;
+    }
+
+    BatchOptions options = {threadCount, windowSize, 0, outputDirectory};
+    BatchReport report;
+    int result = runBatch((const char* const*)files, fileCount, &options, &report);
+    freeBatchInputs(files, fileCount);
+    if (result < 0) {
+        fprintf(stderr, "Failed to start batch processing\n");
+        return 1;
+    }
+
+    printf("Files processed: %d (failed: %d)\n", report.filesProcessed, report.filesFailed);
+    printf("Samples processed: %lld in %.3f s on %d threads\n", report.samplesProcessed, report.seconds, report.threadCount);
+    printf("Throughput: %.0f samples/sec\n", report.samplesPerSecond);
+    return result == 0 ? 0 : 1;
+}
+
+static int runLiveMode(const char* source, int windowSize) {
+    LiveStreamOptions options = {source, windowSize, 0, stdout};
+    LiveStreamReport report;
+    int result = runLiveStream(&options, &report);
+    if (result != 0 && report.samplesProcessed == 0) {
+        fprintf(stderr, "Failed to process live stream %s\n", source);
+        return 1;
+    }
+
+    // 資料列輸出到 stdout，摘要寫到 stderr
+    fprintf(stderr, "Samples processed: %lld in %.3f s (rejected lines: %lld, reader stalls: %lld)\n",
+            report.samplesProcessed, report.seconds, report.linesRejected, report.producerStalls);
+    fprintf(stderr, "Latency: mean %.3f ms, p50 <= %.3f ms, p99 <= %.3f ms, max %.3f ms\n",
+            report.latencyMean * 1e3, report.latencyP50 * 1e3, report.latencyP99 * 1e3, report.latencyMax * 1e3);
+    return result == 0 ? 0 : 1;
+}
+
+// 以四元數與加速度計做 ZUPT 航位推算，輸出步數與步幅
+static void printWalkingSummary(const CsvData* csv, double sampleRate) {
+    int count = csv->totalRows;
+    for (int i = 0; i < csv->columnCount; i++) {
+        if (csv->columns[i].count < count) {
+            count = csv->columns[i].count;
         }
-        totalRows++;
     }
+    ImuRecording recording = {
+        csv->columns[6].data,
+        {csv->columns[7].data, csv->columns[8].data, csv->columns[9].data, csv->columns[10].data},
+        {csv->columns[0].data, csv->columns[1].data, csv->columns[2].data},
+        {csv->columns[3].data, csv->columns[4].data, csv->columns[5].data},
+        count,
+        1,
+    };
+    PedestrianOptions options;
+    pedestrianDefaultOptions(&options);
+    if (sampleRate > 0) {
+        options.sampleRate = sampleRate;
+    }
+    WalkingResult result;
+    if (count <= 0 || analyzeWalkingRecording(&recording, &options, &result, NULL) != 0) {
+        return;
+    }
+    printf("Strides: %d, average stride length: %.3f m, distance: %.3f m\n",
+           result.stepCount, result.averageStrideLength, result.totalDistance);
+    printf("Final position: (%.3f, %.3f, %.3f) m\n", result.finalPosition[0], result.finalPosition[1], result.finalPosition[2]);
+    freeWalkingResult(&result);
+}
 
-    // 打印信息
-    printf("Total Rows: %d\n", totalRows);
-    printf("Data entries in target column (%d): %d\n", targetColumn, index);
+// 以比力大小與 1 g 的差值分段靜止 / 運動區間，不建立逐樣本遮罩
+static int buildAccelIntervalIndex(const CsvData* csv, double sampleRate, IntervalIndex* index) {
+    double rate = sampleRate > 0 ? sampleRate : 1.0;
+    SegmentationOptions options = {0.1, 0.05, (int)ceil(0.1 * rate), (int)ceil(0.2 * rate)}; // g, g, 0.1 s, 0.2 s
+    IntervalSegmenter segmenter;
+    if (intervalIndexInit(index, rate) != 0 || intervalSegmenterInit(&segmenter, &options, index) != 0) {
+        return -1;
+    }
+    int count = csv->columns[0].count;
+    for (int axis = 1; axis < 3; axis++) {
+        if (csv->columns[axis].count < count) {
+            count = csv->columns[axis].count;
+        }
+    }
+    for (int i = 0; i < count; i++) {
+        double ax = csv->columns[0].data[i];
+        double ay = csv->columns[1].data[i];
+        double az = csv->columns[2].data[i];
+        if (intervalSegmenterPush(&segmenter, fabs(sqrt(ax * ax + ay * ay + az * az) - 1.0)) != 0) {
+            freeIntervalIndex(index);
+            return -1;
+        }
+    }
+    if (intervalSegmenterFinish(&segmenter) != 0) {
+        freeIntervalIndex(index);
+        return -1;
+    }
+    return 0;
+}
 
+// 六軸的 Welch 功率譜密度寫成 CSV，並列出 95% 功率所在的頻率，供選擇 cutoffFrequency
+static int writePsdReport(DspContext* context, const char* path, const CsvData* csv, const char* const* labels, double sampleRate) {
+    int count = csv->columns[0].count;
+    for (int axis = 1; axis < 6; axis++) {
+        if (csv->columns[axis].count < count) {
+            count = csv->columns[axis].count;
+        }
+    }
+    int segmentLength = 256;
+    while (segmentLength > count && segmentLength > 2) {
+        segmentLength /= 2;
+    }
+    int bins = segmentLength / 2 + 1;
+    DspContextMark mark = dspContextMark(context);
+    double* psdBlock = dspContextAllocDoubles(context, (size_t)bins * 6);
+    if (psdBlock == NULL || sampleRate <= 0) {
+        dspContextRelease(context, &mark);
+        return -1;
+    }
+    const double* inputs[6];
+    double* psd[6];
+    for (int axis = 0; axis < 6; axis++) {
+        inputs[axis] = csv->columns[axis].data;
+        psd[axis] = psdBlock + (size_t)axis * (size_t)bins;
+    }
+    FILE* file = NULL;
+    if (welchPsdMulti(inputs, psd, 6, count, sampleRate, segmentLength, context) < 0 || (file = fopen(path, "w")) == NULL) {
+        dspContextRelease(context, &mark);
+        return -1;
+    }
+
+    fprintf(file, "frequency");
+    for (int axis = 0; axis < 6; axis++) {
+        fprintf(file, ",%s", labels[axis]);
+    }
+    fprintf(file, "\n");
+    for (int k = 0; k < bins; k++) {
+        fprintf(file, "%g", k * sampleRate / segmentLength);
+        for (int axis = 0; axis < 6; axis++) {
+            fprintf(file, ",%g", psd[axis][k]);
+        }
+        fprintf(file, "\n");
+    }
     fclose(file);
-    return index;  // 返回目标列的数据数量
+
+    for (int axis = 0; axis < 6; axis++) {
+        double total = 0.0;
+        for (int k = 0; k < bins; k++) {
+            total += psd[axis][k];
+        }
+        double running = 0.0;
+        int k = 0;
+        while (k < bins - 1 && running + psd[axis][k] < 0.95 * total) {
+            running += psd[axis][k++];
+        }
+        printf("%s: 95%% of power below %.2f Hz\n", labels[axis], k * sampleRate / segmentLength);
+    }
+    dspContextRelease(context, &mark);
+    return 0;
 }
 
-void printUsage(char *programName) {
-    printf("Usage: %s <path_to_csv>\n", programName);
-    printf("Options:\n");
-    printf("  -h               Display this help message and exit\n");
-    printf("  <path_to_csv>    Path to the CSV file to be processed\n");
+// 完整輸出：每個樣本都寫入暫存檔
+static int writeFullAxis(DspContext* context, Pipeline* pipeline, const double* inputData, int count, double sampleRate,
+                         const char* fileName, char* inputSource, char* outputSource, int sourceSize) {
+    double* outputData = dspContextAllocDoubles(context, (size_t)count);
+    if (outputData == NULL) {
+        return -1;
+    }
+    pipelineRun(pipeline, inputData, outputData, count);
+
+    ColumnSpec tempColumns[2] = {
+        {"input", COLUMN_DTYPE_FLOAT64, inputData},
+        {"output", COLUMN_DTYPE_FLOAT64, outputData},
+    };
+    uint64_t offsets[2];
+    if (writeColumnFile(fileName, sampleRate, count, tempColumns, 2, offsets) != 0
+        || columnFileGnuplotSource(fileName, offsets[0], (uint64_t)count, inputSource, sourceSize) != 0
+        || columnFileGnuplotSource(fileName, offsets[1], (uint64_t)count, outputSource, sourceSize) != 0) {
+        return -1;
+    }
+    return 0;
+}
+
+// 抽稀後的點：先寫輸入再寫輸出，每點一筆 float64 (x, y) 紀錄，gnuplot 以 binary record= 直接讀取
+static int writePointFile(const char* path, const double* inputPoints, const double* outputPoints, int points) {
+    DSP_STATS_TIMER_BEGIN(timer);
+    FILE* file = fopen(path, "wb");
+    if (file == NULL) {
+        perror(path);
+        return -1;
+    }
+    size_t values = 2 * (size_t)points;
+    int ok = fwrite(inputPoints, sizeof(double), values, file) == values
+        && fwrite(outputPoints, sizeof(double), values, file) == values;
+    if (fclose(file) != 0) {
+        ok = 0;
+    }
+    DSP_STATS_TIMER_END(timer, DSP_STAGE_TEMP_WRITE);
+    if (ok) {
+        DSP_STATS_ADD(DSP_COUNTER_BYTES_WRITTEN, 2 * values * sizeof(double));
+    }
+    return ok ? 0 : -1;
+}
+
+// 抽稀輸出：處理鏈逐區塊產生輸出，同一趟同時抽稀輸入與輸出，不保留完整的輸出陣列
+static int writeDecimatedAxis(DspContext* context, Pipeline* pipeline, const double* inputData, int count, DownsampleMode mode,
+                              int plotPoints, const char* fileName, char* inputSource, char* outputSource, int sourceSize) {
+    int points = downsampleCount(mode, count, plotPoints);
+    double* inputPoints = dspContextAllocDoubles(context, 2 * (size_t)points);
+    double* outputPoints = dspContextAllocDoubles(context, 2 * (size_t)points);
+    double* block = dspContextAllocDoubles(context, PIPELINE_BLOCK_SIZE);
+    Downsampler inputDecimator;
+    Downsampler outputDecimator;
+    if (inputPoints == NULL || outputPoints == NULL || block == NULL
+        || downsamplerInit(&inputDecimator, mode, count, plotPoints, inputPoints, context) != 0
+        || downsamplerInit(&outputDecimator, mode, count, plotPoints, outputPoints, context) != 0) {
+        return -1;
+    }
+
+    pipelineReset(pipeline);
+    for (int offset = 0; offset < count; offset += PIPELINE_BLOCK_SIZE) {
+        int blockSize = count - offset < PIPELINE_BLOCK_SIZE ? count - offset : PIPELINE_BLOCK_SIZE;
+        int produced = pipelinePush(pipeline, inputData + offset, block, blockSize);
+        downsamplerPush(&inputDecimator, inputData + offset, blockSize);
+        downsamplerPush(&outputDecimator, block, produced);
+    }
+    int flushed = pipelineFinish(pipeline, block);
+    downsamplerPush(&outputDecimator, block, flushed);
+    if (downsamplerFinish(&inputDecimator) != points || downsamplerFinish(&outputDecimator) != points) {
+        return -1;
+    }
+
+    if (writePointFile(fileName, inputPoints, outputPoints, points) != 0) {
+        return -1;
+    }
+    unsigned long long outputOffset = 2ULL * (unsigned long long)points * sizeof(double);
+    int inputLength = snprintf(inputSource, (size_t)sourceSize,
+                               "'%s' binary record=%d format='%%float64%%float64' endian=little using 1:2", fileName, points);
+    int outputLength = snprintf(outputSource, (size_t)sourceSize,
+                                "'%s' binary skip=%llu record=%d format='%%float64%%float64' endian=little using 1:2",
+                                fileName, outputOffset, points);
+    return inputLength < sourceSize && outputLength < sourceSize ? 0 : -1;
 }
 
 
 int main(int argc, char *argv[]) {
-    if (argc == 2 && strcmp(argv[1], "-h") == 0) {
-        printUsage(argv[0]);
-        return 0;
+    const char* filename = NULL;     // 从命令行参数获取 CSV 文件名
+    const char* batchPath = NULL;
+    const char* outputDirectory = NULL;
+    const char* liveSource = NULL;
+    int threadCount = 0;
+    int printStats = 0;
+    const char* psdPath = NULL;
+    int plotPoints = 2000; // 約為螢幕寬度的像素數
+    DownsampleMode downsampleMode = DOWNSAMPLE_MIN_MAX;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-h") == 0) {
+            printUsage(argv[0]);
+            return 0;
+        } else if (strcmp(argv[i], "--batch") == 0 && i + 1 < argc) {
+            batchPath = argv[++i];
+        } else if (strcmp(argv[i], "--live") == 0 && i + 1 < argc) {
+            liveSource = argv[++i];
+        } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            outputDirectory = argv[++i];
+        } else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            threadCount = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--stats") == 0) {
+            printStats = 1;
+        } else if (strcmp(argv[i], "--psd") == 0 && i + 1 < argc) {
+            psdPath = argv[++i];
+        } else if (strcmp(argv[i], "--plot-points") == 0 && i + 1 < argc) {
+            plotPoints = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--downsample") == 0 && i + 1 < argc
+                   && (strcmp(argv[i + 1], "minmax") == 0 || strcmp(argv[i + 1], "lttb") == 0)) {
+            downsampleMode = strcmp(argv[++i], "lttb") == 0 ? DOWNSAMPLE_LTTB : DOWNSAMPLE_MIN_MAX;
+        } else if (argv[i][0] != '-' && filename == NULL) {
+            filename = argv[i];
+        } else {
+            fprintf(stderr, "Error: Unknown or incomplete argument '%s'.\n", argv[i]);
+            printUsage(argv[0]);
+            return 1;
+        }
     }
 
-    if (argc != 2) {
+    if ((filename != NULL) + (batchPath != NULL) + (liveSource != NULL) != 1) {
         fprintf(stderr, "Error: Incorrect number of arguments.\n");
         printUsage(argv[0]);
         return 1;
     }
 
-    printHelloWorld();
-
-    const char* filename = argv[1];  // 从命令行参数获取 CSV 文件名
-    int maxDataSize = 100000;
     int windowSize = 3; // 窗口大小
+    if (outputDirectory != NULL && batchPath == NULL) {
+        fprintf(stderr, "Error: --output is only used with --batch.\n");
+        return 1;
+    }
+    if (plotPoints < 0) {
+        fprintf(stderr, "Error: --plot-points must not be negative.\n");
+        return 1;
+    }
+
+    if (printStats) {
+#ifdef DSP_ENABLE_STATS
+        dspStatsEnable(1);
+#else
+        fprintf(stderr, "Warning: built without DSP_ENABLE_STATS, --stats reports zeros.\n");
+#endif
+    }
+
+    if (batchPath != NULL) {
+        int status = runBatchMode(batchPath, outputDirectory, threadCount, windowSize);
+        if (printStats) {
+            dspStatsPrintJson(stdout);
+        }
+        return status;
+    }
+
+    if (liveSource != NULL) {
+        int status = runLiveMode(liveSource, windowSize);
+        if (printStats) {
+            dspStatsPrintJson(stderr);
+        }
+        return status;
+    }
+
+    printHelloWorld();
 
     FILE *gnuplotPipe = popen("gnuplot -persistent", "w");
     if (gnuplotPipe == NULL) {
@@ -78,51 +376,99 @@ int main(int argc, char *argv[]) {
 
     fprintf(gnuplotPipe, "set multiplot layout 2,3 title 'Six Axis Data Visualization'\n");
 
+    // 一次讀取 AX, AY, AZ, GX, GY, GZ（第 5 到 10 列）
     const char* labels[] = {"AX", "AY", "AZ", "GX", "GY", "GZ"};
+    int columns[11];
     for (int i = 0; i < 6; i++) {
-        int targetLine = 5 + i;  // 从第 5 行开始，对应 AX, AY, AZ, GX, GY, GZ
-        double* inputData = malloc(sizeof(double) * maxDataSize);
-        double* outputData = malloc(sizeof(double) * maxDataSize);
-
-        if (inputData == NULL || outputData == NULL) {
-            fprintf(stderr, "Memory allocation failed\n");
-            pclose(gnuplotPipe);
-            free(inputData);
-            free(outputData);
-            return 1;
-        }
+        columns[i] = 5 + i;
+    }
+    columns[6] = 0; // 時間戳，用來估計採樣率
+    for (int i = 0; i < 4; i++) {
+        columns[7 + i] = 1 + i; // 四元數 w, x, y, z，用於步態分析
+    }
 
-        int count = readCsvData(filename, inputData, maxDataSize, targetLine);
-        if (count < 0) {
-            fprintf(stderr, "Failed to read CSV data for line %d\n", targetLine);
-            free(inputData);
-            free(outputData);
-            continue;
-        }
+    CsvData csv;
+    if (loadCsvColumns(filename, columns, 11, 0, &csv) != 0) {
+        fprintf(stderr, "Failed to read CSV data from %s\n", filename);
+        pclose(gnuplotPipe);
+        return 1;
+    }
+    printf("Total Rows: %d\n", csv.totalRows);
 
-        calculateMovingAverage(inputData, outputData, count, windowSize);
+    // 所有暫存空間（處理鏈、各軸輸出、頻譜）都取自同一個 context，跨軸重複使用
+    DspContext context;
+    dspContextInit(&context, 0);
+    DspContextMark rateMark = dspContextMark(&context);
+    int timestampCount = csv.columns[6].count;
+    double* rateScratch = timestampCount > 1 ? dspContextAllocDoubles(&context, (size_t)timestampCount - 1) : NULL;
+    double sampleRate = estimateSampleRate(csv.columns[6].data, timestampCount, rateScratch);
+    dspContextRelease(&context, &rateMark);
+    printWalkingSummary(&csv, sampleRate);
+    if (psdPath != NULL && writePsdReport(&context, psdPath, &csv, labels, sampleRate) != 0) {
+        fprintf(stderr, "Failed to write power spectral density to %s\n", psdPath);
+    }
 
-        // 将 inputData 和 outputData 写入临时文件
+    // 運動區間以背景色塊標示在所有子圖上
+    IntervalIndex motionIndex;
+    if (buildAccelIntervalIndex(&csv, sampleRate, &motionIndex) == 0) {
+        int motionCount = intervalIndexWriteGnuplot(gnuplotPipe, &motionIndex, INTERVAL_MOTION);
+        printf("Motion intervals: %d, stationary intervals: %d\n", motionCount, motionIndex.count - motionCount);
+        freeIntervalIndex(&motionIndex);
+    }
+
+    // 處理鏈只建立一次，每個軸重複使用
+    Pipeline pipeline;
+    if (pipelineInit(&pipeline, &context) != 0 || pipelineAddMovingAverage(&pipeline, windowSize) < 0) {
+        fprintf(stderr, "Failed to set up processing pipeline\n");
+        pipelineFree(&pipeline);
+        dspContextFree(&context);
+        pclose(gnuplotPipe);
+        freeCsvData(&csv);
+        return 1;
+    }
+
+    for (int i = 0; i < 6; i++) {
+        const CsvColumn* column = &csv.columns[i];
+        int count = column->count;
+        printf("Data entries in target column (%d): %d, parse errors: %d\n", column->sourceColumn, count, column->parseErrors);
+
+        // 将 inputData 和 outputData 以二進位欄位格式写入临时文件；抽稀時只寫入抽稀後的點
         char tempFileName[50];
-        sprintf(tempFileName, "tempData_%s.temp", labels[i]);
-        FILE *tempFile = fopen(tempFileName, "w");
-        for (int j = 0; j < count; j++) {
-            fprintf(tempFile, "%d %f %f\n", j, inputData[j], outputData[j]);
+        sprintf(tempFileName, plotPoints > 0 ? "tempData_%s.points" : "tempData_%s.cdsp", labels[i]);
+        char inputSource[200];
+        char outputSource[200];
+        DspContextMark mark = dspContextMark(&context);
+        int written = plotPoints > 0
+            ? writeDecimatedAxis(&context, &pipeline, column->data, count, downsampleMode, plotPoints,
+                                 tempFileName, inputSource, outputSource, (int)sizeof(inputSource))
+            : writeFullAxis(&context, &pipeline, column->data, count, sampleRate,
+                            tempFileName, inputSource, outputSource, (int)sizeof(inputSource));
+        dspContextRelease(&context, &mark);
+        if (written != 0) {
+            fprintf(stderr, "Failed to write %s\n", tempFileName);
+            continue;
         }
-        fclose(tempFile);
 
-        // 使用 gnuplot 绘制 inputData 和 outputData
+        // 使用 gnuplot 的 binary 模式直接读取 inputData 和 outputData
+        DSP_STATS_TIMER_BEGIN(plotTimer);
         fprintf(gnuplotPipe, "set title '%s Data'\n", labels[i]);
-        fprintf(gnuplotPipe, "plot '%s' using 1:2 with lines title 'Input', ", tempFileName);
-        fprintf(gnuplotPipe, "'%s' using 1:3 with lines title 'Output'\n", tempFileName);
-
-        free(inputData);
-        free(outputData);
+        fprintf(gnuplotPipe, "plot %s with lines title 'Input', ", inputSource);
+        fprintf(gnuplotPipe, "%s with lines title 'Output'\n", outputSource);
+        DSP_STATS_TIMER_END(plotTimer, DSP_STAGE_GNUPLOT);
     }
+    pipelineFree(&pipeline);
+    dspContextFree(&context);
+    freeCsvData(&csv);
 
+    // pclose 會等待 gnuplot 讀完並繪製所有資料
+    DSP_STATS_TIMER_BEGIN(plotTimer);
     fprintf(gnuplotPipe, "unset multiplot\n");
     fflush(gnuplotPipe);
     pclose(gnuplotPipe);
+    DSP_STATS_TIMER_END(plotTimer, DSP_STAGE_GNUPLOT);
 
+    if (printStats) {
+        dspStatsPrintJson(stdout);
+    }
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,158 @@
+// parallel_scan.c
+#include <math.h>
+#include <stdlib.h>
+
+#include "parallel_scan.h"
+#include "data_processing.h"
+#include "dsp_kernels.h"
+
+typedef enum {
+    SCAN_LOW_PASS,
+    SCAN_ZUPT_VELOCITY
+} ScanKind;
+
+typedef struct {
+    ScanKind kind;
+    const double* input;
+    double* output;
+    double alpha;             // SCAN_LOW_PASS
+    double dt;                // SCAN_ZUPT_VELOCITY
+    double threshold;
+} ScanJob;
+
+typedef struct {
+    const ScanJob* job;
+    int start;
+    int end;
+    double multiplier;        // 區塊的仿射映射：y[end - 1] = multiplier * carry + offset
+    double offset;
+    double carry;             // y[start - 1]
+} ScanChunk;
+
+static inline double zuptVelocityStep(double accel, double previous, double dt, double threshold) {
+    return fabs(accel) < threshold ? 0.0 : previous + accel * dt;
+}
+
+// 第一階段：只讀取輸入，把區塊化簡成單一仿射映射
+static void reduceChunk(void* argument, int workerIndex) {
+    (void)workerIndex;
+    ScanChunk* chunk = argument;
+    const ScanJob* job = chunk->job;
+    double multiplier = 1.0;
+    double offset = 0.0;
+    if (job->kind == SCAN_LOW_PASS) {
+        double decay = 1 - job->alpha;
+        for (int i = chunk->start; i < chunk->end; ++i) {
+            offset = lowPassStep(job->alpha, job->input[i], offset);
+            multiplier *= decay;
+        }
+    } else {
+        // 最後一個靜止樣本之後的積分與進入區塊時的速度無關
+        for (int i = chunk->start; i < chunk->end; ++i) {
+            double accel = job->input[i];
+            if (fabs(accel) < job->threshold) {
+                multiplier = 0.0;
+                offset = 0.0;
+            } else {
+                offset += accel * job->dt;
+            }
+        }
+    }
+    chunk->multiplier = multiplier;
+    chunk->offset = offset;
+}
+
+// 第二階段：從正確的進位值開始執行一般的序列遞迴
+static void scanChunk(void* argument, int workerIndex) {
+    (void)workerIndex;
+    ScanChunk* chunk = argument;
+    const ScanJob* job = chunk->job;
+    double value = chunk->carry;
+    if (job->kind == SCAN_LOW_PASS) {
+        for (int i = chunk->start; i < chunk->end; ++i) {
+            value = lowPassStep(job->alpha, job->input[i], value);
+            job->output[i] = value;
+        }
+    } else {
+        for (int i = chunk->start; i < chunk->end; ++i) {
+            value = zuptVelocityStep(job->input[i], value, job->dt, job->threshold);
+            job->output[i] = value;
+        }
+    }
+}
+
+static int chunkCount(ThreadPool* pool, int length) {
+    if (pool == NULL) {
+        return 1;
+    }
+    int count = threadPoolSize(pool);
+    int limit = length / PARALLEL_SCAN_MIN_CHUNK;
+    return count < limit ? count : (limit > 0 ? limit : 1);
+}
+
+// 對 [start, end) 執行遞迴，y[start - 1] = initial
+static void runScan(ThreadPool* pool, const ScanJob* job, int start, int end, double initial) {
+    int count = chunkCount(pool, end - start);
+    ScanChunk* chunks = count > 1 ? malloc(sizeof(ScanChunk) * (size_t)count) : NULL;
+    if (chunks == NULL) {
+        // 單一區塊（或配置失敗）：直接在呼叫端序列執行
+        ScanChunk whole = {job, start, end, 1.0, 0.0, initial};
+        scanChunk(&whole, 0);
+        return;
+    }
+
+    for (int c = 0; c < count; ++c) {
+        chunks[c].job = job;
+        chunks[c].start = start + (int)((long long)(end - start) * c / count);
+        chunks[c].end = start + (int)((long long)(end - start) * (c + 1) / count);
+    }
+    // 最後一個區塊的映射用不到
+    for (int c = 0; c < count - 1; ++c) {
+        if (threadPoolSubmit(pool, reduceChunk, &chunks[c]) != 0) {
+            reduceChunk(&chunks[c], 0);
+        }
+    }
+    threadPoolWait(pool);
+
+    chunks[0].carry = initial;
+    for (int c = 1; c < count; ++c) {
+        chunks[c].carry = chunks[c - 1].multiplier * chunks[c - 1].carry + chunks[c - 1].offset;
+    }
+    for (int c = 0; c < count; ++c) {
+        if (threadPoolSubmit(pool, scanChunk, &chunks[c]) != 0) {
+            scanChunk(&chunks[c], 0);
+        }
+    }
+    threadPoolWait(pool);
+    free(chunks);
+}
+
+static void lowPass(ThreadPool* pool, const double* inputData, double* outputData, int dataSize, double alpha) {
+    ScanJob job = {SCAN_LOW_PASS, inputData, outputData, alpha, 0.0, 0.0};
+    outputData[0] = inputData[0];
+    runScan(pool, &job, 1, dataSize, inputData[0]);
+}
+
+int parallelButterworthLowPassFilter(ThreadPool* pool, const double* inputData, double* outputData, int dataSize, double cutoffFrequency, double samplingRate) {
+    if (inputData == NULL || outputData == NULL || dataSize <= 0 || cutoffFrequency <= 0 || samplingRate <= 0) {
+        return -1;
+    }
+    lowPass(pool, inputData, outputData, dataSize, butterworthAlpha(cutoffFrequency, samplingRate));
+    return 0;
+}
+
+void parallelApplyLowPassFilter(ThreadPool* pool, double* data, int dataSize) {
+    if (data == NULL || dataSize <= 0) {
+        return;
+    }
+    lowPass(pool, data, data, dataSize, APPLY_LOW_PASS_ALPHA);
+}
+
+int integrateVelocityZupt(ThreadPool* pool, const double* accelData, double* velocityData, int dataSize, double dt, double threshold) {
+    if (accelData == NULL || velocityData == NULL || dataSize <= 0) {
+        return -1;
+    }
+    ScanJob job = {SCAN_ZUPT_VELOCITY, accelData, velocityData, 0.0, dt, threshold};
+    runScan(pool, &job, 0, dataSize, 0.0);
+    return 0;
+}
@@ -0,0 +1,62 @@
+// parallel_scan.h
+
+#ifndef PARALLEL_SCAN_H
+#define PARALLEL_SCAN_H
+
+#include "thread_pool.h"
+
+/*
+ * Multi-core execution of first-order recursive filters.
+ *
+ * The low-pass recurrence y[i] = alpha * x[i] + (1 - alpha) * y[i - 1] and the ZUPT
+ * velocity integration v[i] = v[i - 1] + a[i] * dt (or 0 while stationary) are both
+ * affine maps y[i] = m[i] * y[i - 1] + b[i]. Affine maps compose associatively, so the
+ * array is split into one chunk per pool worker and filtered in two passes:
+ *
+ *   1. every chunk but the last reduces its samples to a single map (M, B) such that
+ *      y[end] = M * y[start - 1] + B, in parallel;
+ *   2. the carries y[start - 1] are chained through those maps in chunk order (one step
+ *      per chunk), then every chunk runs the ordinary serial recurrence from its carry,
+ *      in parallel.
+ *
+ * Pass 2 performs the same operations as the serial functions, so the only difference is
+ * the rounding of each carry, which decays geometrically into the chunk (low-pass) or is
+ * reset at the next stationary sample (ZUPT); the results match the serial ones to
+ * within a few ulps of the signal. Pass 1 only reads the input, so filtering in place is
+ * allowed.
+ *
+ * With a NULL pool, a single worker or fewer than two chunks of PARALLEL_SCAN_MIN_CHUNK
+ * samples the functions run serially on the calling thread. They must not be called from
+ * inside a task of the same pool (threadPoolWait() would deadlock).
+ */
+
+#define PARALLEL_SCAN_MIN_CHUNK 32768   // 每個區塊至少的樣本數，太小時同步成本大於收益
+
+/**
+ * Parallel butterworthLowPassFilter().
+ *
+ * @return 0 on success, -1 on invalid arguments.
+ *
+ * Example usage:
+ *     ThreadPool* pool = threadPoolCreate(0);
+ *     parallelButterworthLowPassFilter(pool, data, filteredData, dataSize, 5.0, 100.0);
+ *     threadPoolDestroy(pool);
+ */
+int parallelButterworthLowPassFilter(ThreadPool* pool, const double* inputData, double* outputData, int dataSize, double cutoffFrequency, double samplingRate);
+
+/**
+ * Parallel applyLowPassFilter() (alpha = APPLY_LOW_PASS_ALPHA), in place.
+ */
+void parallelApplyLowPassFilter(ThreadPool* pool, double* data, int dataSize);
+
+/**
+ * Integrates acceleration into velocity with zero-velocity updates: velocityData[i] is
+ * 0 when |accelData[i]| < threshold (the sample is zeroed exactly as applyZupt() does)
+ * and velocityData[i - 1] + accelData[i] * dt otherwise, starting from rest.
+ *
+ * @param pool Workers to use, or NULL to run serially.
+ * @return 0 on success, -1 on invalid arguments.
+ */
+int integrateVelocityZupt(ThreadPool* pool, const double* accelData, double* velocityData, int dataSize, double dt, double threshold);
+
+#endif // PARALLEL_SCAN_H
@@ -0,0 +1,198 @@
+// pedestrian.c
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "pedestrian.h"
+
+#define PEDESTRIAN_MAX_DT 1.0   // 超過此間隔（或非遞增）的時間戳視為無效
+
+void pedestrianDefaultOptions(PedestrianOptions* options) {
+    options->sampleRate = 100.0;
+    options->gravity = 9.80665;
+    options->accelThreshold = 1.0;
+    options->gyroThreshold = 40.0;
+    options->minStanceSeconds = 0.05;
+    options->minSwingSeconds = 0.1;
+}
+
+// 以單位四元數 q = (w, u) 旋轉向量：v' = v + w t + u x t，其中 t = 2 u x v
+static void rotateVector(const double q[4], const double v[3], double out[3]) {
+    double tx = 2.0 * (q[2] * v[2] - q[3] * v[1]);
+    double ty = 2.0 * (q[3] * v[0] - q[1] * v[2]);
+    double tz = 2.0 * (q[1] * v[1] - q[2] * v[0]);
+    out[0] = v[0] + q[0] * tx + (q[2] * tz - q[3] * ty);
+    out[1] = v[1] + q[0] * ty + (q[3] * tx - q[1] * tz);
+    out[2] = v[2] + q[0] * tz + (q[1] * ty - q[2] * tx);
+}
+
+static int appendStride(WalkingResult* result, double length) {
+    if (result->stepCount == result->strideCapacity) {
+        int newCapacity = result->strideCapacity > 0 ? result->strideCapacity * 2 : 64;
+        double* grown = realloc(result->strideLengths, sizeof(double) * (size_t)newCapacity);
+        if (grown == NULL) {
+            return -1;
+        }
+        result->strideLengths = grown;
+        result->strideCapacity = newCapacity;
+    }
+    result->strideLengths[result->stepCount++] = length;
+    result->totalDistance += length;
+    return 0;
+}
+
+/*
+ * Removes a velocity error that grew linearly from zero to residual over the swing of
+ * sampleCount samples (mean interval stepDt). With Euler integration the position error
+ * after swing sample k is stepDt * residual * k (k + 1) / (2 sampleCount).
+ */
+static void correctSwing(const double residual[3], int sampleCount, double stepDt, double position[3], double* const* trajectory, int swingStart) {
+    double scale = stepDt / (2.0 * sampleCount);
+    if (trajectory != NULL) {
+        for (int k = 1; k <= sampleCount; ++k) {
+            double factor = scale * (double)k * (double)(k + 1);
+            for (int axis = 0; axis < 3; ++axis) {
+                trajectory[axis][swingStart + k - 1] -= residual[axis] * factor;
+            }
+        }
+    }
+    double factor = scale * (double)sampleCount * (double)(sampleCount + 1);
+    for (int axis = 0; axis < 3; ++axis) {
+        position[axis] -= residual[axis] * factor;
+    }
+}
+
+int analyzeWalkingRecording(const ImuRecording* recording, const PedestrianOptions* options, WalkingResult* result, double* const* trajectory) {
+    if (recording == NULL || result == NULL || recording->sampleCount < 0 || recording->stride < 1) {
+        return -1;
+    }
+    for (int axis = 0; axis < 4; ++axis) {
+        if (recording->quaternion[axis] == NULL || (axis < 3 && (recording->accel[axis] == NULL || recording->gyro[axis] == NULL))) {
+            return -1;
+        }
+    }
+    if (trajectory != NULL && (trajectory[0] == NULL || trajectory[1] == NULL || trajectory[2] == NULL)) {
+        return -1;
+    }
+    PedestrianOptions o;
+    if (options != NULL) {
+        o = *options;
+    } else {
+        pedestrianDefaultOptions(&o);
+    }
+    if (o.sampleRate <= 0 || o.gravity <= 0) {
+        return -1;
+    }
+    memset(result, 0, sizeof(*result));
+
+    const double nominalDt = 1.0 / o.sampleRate;
+    double q[4] = {1.0, 0.0, 0.0, 0.0};
+    double velocity[3] = {0.0, 0.0, 0.0};
+    double position[3] = {0.0, 0.0, 0.0};
+    double anchor[3] = {0.0, 0.0, 0.0};  // 上一次站立期的位置
+    int hasAnchor = 0;
+    int inStance = 0;
+    double stillTime = 0.0;              // 站立條件已連續成立的時間
+    double swingTime = 0.0;
+    int swingSamples = 0;
+    int swingStart = 0;
+    double previousTime = 0.0;
+
+    for (int i = 0; i < recording->sampleCount; ++i) {
+        size_t k = (size_t)i * (size_t)recording->stride;
+
+        double dt = 0.0;
+        if (recording->timestamp != NULL) {
+            double time = recording->timestamp[k];
+            double delta = time - previousTime;
+            if (i > 0) {
+                dt = delta > 0.0 && delta < PEDESTRIAN_MAX_DT ? delta : nominalDt;
+            }
+            previousTime = time;
+        } else if (i > 0) {
+            dt = nominalDt;
+        }
+
+        // 退化（全零）的四元數沿用上一個有效姿態
+        double w = recording->quaternion[0][k];
+        double x = recording->quaternion[1][k];
+        double y = recording->quaternion[2][k];
+        double z = recording->quaternion[3][k];
+        double norm2 = w * w + x * x + y * y + z * z;
+        if (norm2 > 1e-12) {
+            double inverse = 1.0 / sqrt(norm2);
+            q[0] = w * inverse;
+            q[1] = x * inverse;
+            q[2] = y * inverse;
+            q[3] = z * inverse;
+        }
+
+        double body[3];
+        double gyro2 = 0.0;
+        for (int axis = 0; axis < 3; ++axis) {
+            body[axis] = recording->accel[axis][k] * o.gravity;
+            double rate = recording->gyro[axis][k];
+            gyro2 += rate * rate;
+        }
+        double specificForce = sqrt(body[0] * body[0] + body[1] * body[1] + body[2] * body[2]);
+        int still = fabs(specificForce - o.gravity) < o.accelThreshold && gyro2 < o.gyroThreshold * o.gyroThreshold;
+        stillTime = still ? stillTime + dt : 0.0;
+
+        if (!inStance && still && stillTime >= o.minStanceSeconds) {
+            // 進入站立期：先移除擺動期的線性漂移，再記錄步幅
+            if (swingSamples > 0) {
+                correctSwing(velocity, swingSamples, swingTime / swingSamples, position, trajectory, swingStart);
+            }
+            if (hasAnchor && swingTime >= o.minSwingSeconds) {
+                double length = hypot(position[0] - anchor[0], position[1] - anchor[1]);
+                if (appendStride(result, length) != 0) {
+                    freeWalkingResult(result);
+                    return -1;
+                }
+            }
+            if (!hasAnchor || swingTime >= o.minSwingSeconds) {
+                memcpy(anchor, position, sizeof(anchor));
+                hasAnchor = 1;
+            }
+            inStance = 1;
+        } else if (inStance && !still) {
+            inStance = 0;
+            swingTime = 0.0;
+            swingSamples = 0;
+            swingStart = i;
+        }
+
+        if (inStance) {
+            velocity[0] = velocity[1] = velocity[2] = 0.0; // ZUPT
+            result->stanceSamples++;
+        } else {
+            double world[3];
+            rotateVector(q, body, world);
+            world[2] -= o.gravity;
+            for (int axis = 0; axis < 3; ++axis) {
+                velocity[axis] += world[axis] * dt;
+                position[axis] += velocity[axis] * dt;
+            }
+            swingTime += dt;
+            swingSamples++;
+        }
+
+        if (trajectory != NULL) {
+            trajectory[0][i] = position[0];
+            trajectory[1][i] = position[1];
+            trajectory[2][i] = position[2];
+        }
+    }
+
+    memcpy(result->finalPosition, position, sizeof(position));
+    result->averageStrideLength = result->stepCount > 0 ? result->totalDistance / result->stepCount : 0.0;
+    return 0;
+}
+
+void freeWalkingResult(WalkingResult* result) {
+    if (result == NULL) {
+        return;
+    }
+    free(result->strideLengths);
+    memset(result, 0, sizeof(*result));
+}
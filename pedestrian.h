@@ -0,0 +1,91 @@
+// pedestrian.h
+
+#ifndef PEDESTRIAN_H
+#define PEDESTRIAN_H
+
+/*
+ * Single-pass step detection and ZUPT dead reckoning for a foot-mounted IMU.
+ *
+ * For every sample the accelerometer reading is rotated into the world frame with the
+ * orientation quaternion, gravity is removed and the result is integrated into velocity
+ * and position. Stance phases (foot flat on the ground) are detected from the specific
+ * force magnitude and the angular rate; during every stance the velocity is reset to
+ * zero (zero velocity update), and the velocity error left over at the end of each swing
+ * is removed from the swing as a linear drift. Each swing between two stances is one
+ * stride of the instrumented foot.
+ *
+ * The cost is a fixed amount of arithmetic per sample plus, when a trajectory is
+ * requested, one extra touch of each swing sample for the drift correction, so an hour-long
+ * 1 kHz recording is processed in a few tens of milliseconds.
+ */
+
+#define PEDESTRIAN_RECORD_COLUMNS 11   // values per demo.csv row
+
+/**
+ * Column views of an IMU recording in the demo.csv layout: timestamp (s), quaternion
+ * w/x/y/z (body to world), accelerometer AX/AY/AZ (g) and gyroscope GX/GY/GZ (deg/s).
+ *
+ * Sample i of a column is column[i * stride], so the same view describes separate
+ * arrays (stride 1) and row-major records (stride 11, pointers into the first row).
+ * timestamp may be NULL, in which case PedestrianOptions.sampleRate is used.
+ */
+typedef struct {
+    const double* timestamp;
+    const double* quaternion[4];
+    const double* accel[3];
+    const double* gyro[3];
+    int sampleCount;
+    int stride;
+} ImuRecording;
+
+typedef struct {
+    double sampleRate;            // Hz; used when timestamps are missing or invalid
+    double gravity;               // m/s^2 per g of the accelerometer columns
+    double accelThreshold;        // stance if | |a| - g | is below this (m/s^2) ...
+    double gyroThreshold;         // ... and |gyro| is below this (deg/s)
+    double minStanceSeconds;      // the stance condition must hold this long
+    double minSwingSeconds;       // shorter swings are not counted as strides
+} PedestrianOptions;
+
+typedef struct {
+    int stepCount;                // strides of the instrumented foot
+    double totalDistance;         // sum of the horizontal stride lengths (m)
+    double averageStrideLength;   // totalDistance / stepCount, 0 without strides (m)
+    double* strideLengths;        // stepCount horizontal stride lengths (m)
+    int strideCapacity;
+    int stanceSamples;            // samples on which ZUPT was applied
+    double finalPosition[3];      // world-frame position after the last sample (m)
+} WalkingResult;
+
+/**
+ * Fills options with defaults for a foot-mounted sensor: 100 Hz fallback rate,
+ * 9.80665 m/s^2 per g, 1.0 m/s^2 and 40 deg/s stance thresholds, 50 ms minimum stance,
+ * 100 ms minimum swing.
+ */
+void pedestrianDefaultOptions(PedestrianOptions* options);
+
+/**
+ * Analyzes a whole recording in one pass.
+ *
+ * @param recording The input columns.
+ * @param options Detection parameters, or NULL for pedestrianDefaultOptions().
+ * @param result Receives the stride statistics; release with freeWalkingResult().
+ * @param trajectory NULL, or three pointers to arrays of sampleCount doubles that
+ *                   receive the drift-corrected world-frame x, y and z position (m)
+ *                   of every sample, starting at the origin.
+ *
+ * @return 0 on success, -1 on invalid arguments or allocation failure.
+ *
+ * Example usage:
+ *     ImuRecording recording = {t, {qw, qx, qy, qz}, {ax, ay, az}, {gx, gy, gz}, count, 1};
+ *     WalkingResult result;
+ *     if (analyzeWalkingRecording(&recording, NULL, &result, NULL) == 0) {
+ *         printf("%d strides, %.2f m\n", result.stepCount, result.totalDistance);
+ *         freeWalkingResult(&result);
+ *     }
+ */
+int analyzeWalkingRecording(const ImuRecording* recording, const PedestrianOptions* options, WalkingResult* result, double* const* trajectory);
+
+void freeWalkingResult(WalkingResult* result);
+
+#endif // PEDESTRIAN_H
@@ -0,0 +1,240 @@
+// pipeline.c
+#include <stdlib.h>
+#include <string.h>
+
+#include "pipeline.h"
+#include "dsp_stats.h"
+
+int pipelineInit(Pipeline* pipeline, DspContext* context) {
+    if (pipeline == NULL) {
+        return -1;
+    }
+    memset(pipeline, 0, sizeof(*pipeline));
+    pipeline->context = context;
+    if (context != NULL) {
+        pipeline->block = dspContextAllocDoubles(context, PIPELINE_BLOCK_SIZE);
+    } else {
+        pipeline->block = malloc(sizeof(double) * PIPELINE_BLOCK_SIZE);
+        DSP_STATS_ADD(DSP_COUNTER_BUFFER_ALLOCATIONS, 1);
+    }
+    return pipeline->block != NULL ? 0 : -1;
+}
+
+static PipelineStage* appendStage(Pipeline* pipeline, PipelineStageType type) {
+    if (pipeline == NULL || pipeline->stageCount >= PIPELINE_MAX_STAGES) {
+        return NULL;
+    }
+    PipelineStage* stage = &pipeline->stages[pipeline->stageCount];
+    memset(stage, 0, sizeof(*stage));
+    stage->type = type;
+    return stage;
+}
+
+int pipelineAddSubtractBias(Pipeline* pipeline, double bias) {
+    PipelineStage* stage = appendStage(pipeline, PIPELINE_STAGE_SUBTRACT_BIAS);
+    if (stage == NULL) {
+        return -1;
+    }
+    stage->state.bias = bias;
+    return pipeline->stageCount++;
+}
+
+int pipelineAddLowPass(Pipeline* pipeline, double alpha) {
+    PipelineStage* stage = appendStage(pipeline, PIPELINE_STAGE_LOW_PASS);
+    if (stage == NULL) {
+        return -1;
+    }
+    lowPassInit(&stage->state.lowPass, alpha);
+    return pipeline->stageCount++;
+}
+
+int pipelineAddButterworthLowPass(Pipeline* pipeline, double cutoffFrequency, double samplingRate) {
+    PipelineStage* stage = appendStage(pipeline, PIPELINE_STAGE_LOW_PASS);
+    if (stage == NULL || lowPassInitButterworth(&stage->state.lowPass, cutoffFrequency, samplingRate) != 0) {
+        return -1;
+    }
+    return pipeline->stageCount++;
+}
+
+int pipelineAddButterworth(Pipeline* pipeline, ButterworthType type, int order, double lowCutoff, double highCutoff, double samplingRate) {
+    PipelineStage* stage = appendStage(pipeline, PIPELINE_STAGE_BUTTERWORTH);
+    if (stage == NULL || butterworthDesign(&stage->state.butterworth, type, order, lowCutoff, highCutoff, samplingRate, 1) != 0) {
+        return -1;
+    }
+    return pipeline->stageCount++;
+}
+
+int pipelineAddMovingAverage(Pipeline* pipeline, int windowSize) {
+    PipelineStage* stage = appendStage(pipeline, PIPELINE_STAGE_MOVING_AVERAGE);
+    if (stage == NULL) {
+        return -1;
+    }
+    MovingAverageState* state = &stage->state.movingAverage;
+    int status = pipeline->context != NULL && windowSize > 0
+        ? movingAverageInitBuffer(state, windowSize, dspContextAllocDoubles(pipeline->context, (size_t)windowSize))
+        : movingAverageInit(state, windowSize);
+    if (status != 0) {
+        return -1;
+    }
+    return pipeline->stageCount++;
+}
+
+int pipelineAddDetectMovement(Pipeline* pipeline, double threshold, double samplingRate) {
+    PipelineStage* stage = appendStage(pipeline, PIPELINE_STAGE_DETECT_MOVEMENT);
+    if (stage == NULL || movementDetectorInit(&stage->state.movement, threshold, samplingRate) != 0) {
+        return -1;
+    }
+    return pipeline->stageCount++;
+}
+
+int pipelineSetTap(Pipeline* pipeline, int stageIndex, double* tap) {
+    if (pipeline == NULL || stageIndex < 0 || stageIndex >= pipeline->stageCount) {
+        return -1;
+    }
+    pipeline->stages[stageIndex].tap = tap;
+    return 0;
+}
+
+static void emitTap(PipelineStage* stage, const double* block, int count) {
+    if (stage->tap != NULL && count > 0) {
+        memcpy(stage->tap + stage->produced, block, sizeof(double) * (size_t)count);
+    }
+    stage->produced += count;
+}
+
+// 在區塊上原地執行一個階段，回傳輸出的樣本數
+static int runStage(PipelineStage* stage, double* block, int count) {
+    switch (stage->type) {
+    case PIPELINE_STAGE_SUBTRACT_BIAS:
+        for (int i = 0; i < count; ++i) {
+            block[i] -= stage->state.bias;
+        }
+        break;
+    case PIPELINE_STAGE_LOW_PASS:
+        lowPassPushBlock(&stage->state.lowPass, block, block, count);
+        break;
+    case PIPELINE_STAGE_BUTTERWORTH: {
+        double* channel[1] = {block};
+        biquadCascadeProcess(&stage->state.butterworth, (const double* const*)channel, channel, count);
+        break;
+    }
+    case PIPELINE_STAGE_MOVING_AVERAGE:
+        movingAveragePushBlock(&stage->state.movingAverage, block, block, count);
+        break;
+    case PIPELINE_STAGE_DETECT_MOVEMENT:
+        count = movementDetectorPushBlock(&stage->state.movement, block, block, count);
+        break;
+    }
+    emitTap(stage, block, count);
+    return count;
+}
+
+static int runStages(Pipeline* pipeline, int firstStage, double* block, int count) {
+    for (int s = firstStage; s < pipeline->stageCount && count > 0; ++s) {
+        count = runStage(&pipeline->stages[s], block, count);
+    }
+    return count;
+}
+
+int pipelinePush(Pipeline* pipeline, const double* inputData, double* outputData, int dataSize) {
+    if (pipeline == NULL || pipeline->block == NULL || inputData == NULL || dataSize < 0) {
+        return -1;
+    }
+
+    DSP_STATS_TIMER_BEGIN(timer);
+    int written = 0;
+    for (int position = 0; position < dataSize; position += PIPELINE_BLOCK_SIZE) {
+        int count = dataSize - position;
+        if (count > PIPELINE_BLOCK_SIZE) {
+            count = PIPELINE_BLOCK_SIZE;
+        }
+        memcpy(pipeline->block, inputData + position, sizeof(double) * (size_t)count);
+        count = runStages(pipeline, 0, pipeline->block, count);
+        if (outputData != NULL && count > 0) {
+            memcpy(outputData + written, pipeline->block, sizeof(double) * (size_t)count);
+        }
+        written += count;
+    }
+    DSP_STATS_TIMER_END(timer, DSP_STAGE_FILTER);
+    DSP_STATS_ADD(DSP_COUNTER_SAMPLES_PROCESSED, dataSize);
+    return written;
+}
+
+int pipelineFinish(Pipeline* pipeline, double* outputData) {
+    if (pipeline == NULL || pipeline->block == NULL) {
+        return 0;
+    }
+
+    // 依序沖出每個 detectMovement 階段延遲的最後一個樣本，並送入後續階段
+    int written = 0;
+    for (int s = 0; s < pipeline->stageCount; ++s) {
+        PipelineStage* stage = &pipeline->stages[s];
+        if (stage->type != PIPELINE_STAGE_DETECT_MOVEMENT) {
+            continue;
+        }
+        if (movementDetectorFlush(&stage->state.movement, pipeline->block) == 0) {
+            continue;
+        }
+        emitTap(stage, pipeline->block, 1);
+        int count = runStages(pipeline, s + 1, pipeline->block, 1);
+        if (outputData != NULL && count > 0) {
+            outputData[written] = pipeline->block[0];
+        }
+        written += count;
+    }
+    return written;
+}
+
+int pipelineRun(Pipeline* pipeline, const double* inputData, double* outputData, int dataSize) {
+    if (pipeline == NULL || inputData == NULL || dataSize < 0) {
+        return -1;
+    }
+    pipelineReset(pipeline);
+    int written = pipelinePush(pipeline, inputData, outputData, dataSize);
+    if (written < 0) {
+        return -1;
+    }
+    return written + pipelineFinish(pipeline, outputData != NULL ? outputData + written : NULL);
+}
+
+void pipelineReset(Pipeline* pipeline) {
+    if (pipeline == NULL) {
+        return;
+    }
+    for (int s = 0; s < pipeline->stageCount; ++s) {
+        PipelineStage* stage = &pipeline->stages[s];
+        stage->produced = 0;
+        switch (stage->type) {
+        case PIPELINE_STAGE_SUBTRACT_BIAS:
+            break;
+        case PIPELINE_STAGE_LOW_PASS:
+            lowPassReset(&stage->state.lowPass);
+            break;
+        case PIPELINE_STAGE_BUTTERWORTH:
+            biquadCascadeReset(&stage->state.butterworth);
+            break;
+        case PIPELINE_STAGE_MOVING_AVERAGE:
+            movingAverageReset(&stage->state.movingAverage);
+            break;
+        case PIPELINE_STAGE_DETECT_MOVEMENT:
+            movementDetectorReset(&stage->state.movement);
+            break;
+        }
+    }
+}
+
+void pipelineFree(Pipeline* pipeline) {
+    if (pipeline == NULL) {
+        return;
+    }
+    for (int s = 0; s < pipeline->stageCount; ++s) {
+        if (pipeline->stages[s].type == PIPELINE_STAGE_MOVING_AVERAGE) {
+            movingAverageFree(&pipeline->stages[s].state.movingAverage);
+        }
+    }
+    if (pipeline->context == NULL) {
+        free(pipeline->block);
+    }
+    pipeline->block = NULL;
+    pipeline->stageCount = 0;
+}
@@ -0,0 +1,154 @@
+// pipeline.h
+
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include "stream_filters.h"
+#include "butterworth_filter.h"
+#include "dsp_context.h"
+
+/**
+ * Maximum number of stages in one pipeline.
+ */
+#define PIPELINE_MAX_STAGES 16
+
+/**
+ * Number of samples processed by every stage before moving to the next block. 4096
+ * doubles (32 KB) keep the working block resident in L1/L2 while it flows through all
+ * stages.
+ */
+#define PIPELINE_BLOCK_SIZE 4096
+
+typedef enum {
+    PIPELINE_STAGE_SUBTRACT_BIAS,
+    PIPELINE_STAGE_LOW_PASS,
+    PIPELINE_STAGE_BUTTERWORTH,
+    PIPELINE_STAGE_MOVING_AVERAGE,
+    PIPELINE_STAGE_DETECT_MOVEMENT
+} PipelineStageType;
+
+typedef struct {
+    PipelineStageType type;
+    union {
+        double bias;
+        LowPassState lowPass;
+        BiquadCascade butterworth;
+        MovingAverageState movingAverage;
+        MovementDetectorState movement;
+    } state;
+    double* tap;          // optional destination for this stage's output
+    long long produced;   // samples emitted by this stage so far
+} PipelineStage;
+
+/**
+ * A single-channel chain of processing stages executed fused, block by block.
+ *
+ * Instead of one full pass over memory (and one intermediate array) per function, each
+ * block of PIPELINE_BLOCK_SIZE samples runs through every stage while it is hot in
+ * cache. Every stage uses the streaming state objects from stream_filters.h, so the
+ * final output (and every tap) is bit-identical to calling the batch functions one
+ * after another on full arrays (for a detect-movement stage, on at least three samples;
+ * see MovementDetectorState).
+ *
+ * Example usage (subtractBias -> applyLowPassFilter -> calculateMovingAverage ->
+ * detectMovement, keeping the smoothed signal for plotting):
+ *     Pipeline pipeline;
+ *     pipelineInit(&pipeline, &context);
+ *     pipelineAddSubtractBias(&pipeline, bias);
+ *     pipelineAddLowPass(&pipeline, APPLY_LOW_PASS_ALPHA);
+ *     int smooth = pipelineAddMovingAverage(&pipeline, 50);
+ *     pipelineAddDetectMovement(&pipeline, 0.5, 1000.0);
+ *     pipelineSetTap(&pipeline, smooth, smoothed);
+ *     pipelineRun(&pipeline, input, movement, dataSize);
+ *     pipelineFree(&pipeline);
+ */
+typedef struct {
+    PipelineStage stages[PIPELINE_MAX_STAGES];
+    int stageCount;
+    double* block;        // PIPELINE_BLOCK_SIZE samples of scratch
+    DspContext* context;  // owner of block and stage buffers, NULL for the heap
+} Pipeline;
+
+/**
+ * Initializes an empty pipeline.
+ *
+ * @param context Arena for the block buffer and the stage buffers (moving-average rings),
+ *                or NULL to use malloc. With a context, the pipeline must be freed before
+ *                the context is released past the point where it was initialized.
+ * @return 0 on success, -1 if the block buffer cannot be allocated.
+ */
+int pipelineInit(Pipeline* pipeline, DspContext* context);
+
+/*
+ * Stage constructors. Each appends a stage and returns its index (for pipelineSetTap()),
+ * or -1 if the pipeline is full or a parameter is invalid.
+ */
+
+/** subtractBias(): x - bias. */
+int pipelineAddSubtractBias(Pipeline* pipeline, double bias);
+
+/** First-order low-pass; APPLY_LOW_PASS_ALPHA matches applyLowPassFilter(). */
+int pipelineAddLowPass(Pipeline* pipeline, double alpha);
+
+/** First-order low-pass matching butterworthLowPassFilter(). */
+int pipelineAddButterworthLowPass(Pipeline* pipeline, double cutoffFrequency, double samplingRate);
+
+/** Nth-order Butterworth cascade, see butterworthDesign(). */
+int pipelineAddButterworth(Pipeline* pipeline, ButterworthType type, int order, double lowCutoff, double highCutoff, double samplingRate);
+
+/** calculateMovingAverage(). */
+int pipelineAddMovingAverage(Pipeline* pipeline, int windowSize);
+
+/**
+ * detectMovement(). The stage delays its output by one sample internally; the pipeline
+ * flushes it at the end of pipelineRun()/pipelineFinish(), so overall output length is
+ * unchanged.
+ */
+int pipelineAddDetectMovement(Pipeline* pipeline, double threshold, double samplingRate);
+
+/**
+ * Materializes the output of one stage into tap, which must hold as many samples as
+ * will be pushed. Stages without a tap never write their intermediate result anywhere.
+ *
+ * @return 0 on success, -1 if stageIndex is out of range.
+ */
+int pipelineSetTap(Pipeline* pipeline, int stageIndex, double* tap);
+
+/**
+ * Runs a complete recording through the pipeline: resets every stage, pushes
+ * inputData and flushes.
+ *
+ * @param outputData Receives the output of the last stage (dataSize samples), or NULL
+ *                   if only taps are wanted. May alias inputData.
+ *
+ * @return The number of samples written to outputData (dataSize), or -1 on error.
+ */
+int pipelineRun(Pipeline* pipeline, const double* inputData, double* outputData, int dataSize);
+
+/**
+ * Streaming entry point: pushes dataSize more samples.
+ *
+ * @return The number of final-stage samples written to outputData. This is less than
+ *         dataSize only for the first block(s) when detectMovement stages are present.
+ */
+int pipelinePush(Pipeline* pipeline, const double* inputData, double* outputData, int dataSize);
+
+/**
+ * Flushes delayed samples at the end of a stream.
+ *
+ * @param outputData Receives at most one sample per detectMovement stage; may be NULL.
+ * @return The number of samples written.
+ */
+int pipelineFinish(Pipeline* pipeline, double* outputData);
+
+/**
+ * Resets every stage and tap position, keeping the configuration.
+ */
+void pipelineReset(Pipeline* pipeline);
+
+/**
+ * Releases all memory owned by the pipeline.
+ */
+void pipelineFree(Pipeline* pipeline);
+
+#endif // PIPELINE_H
@@ -0,0 +1,369 @@
+// sliding_stats.c
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sliding_stats.h"
+
+#define VARIANCE_RECOMPUTE_WINDOWS 64   // 每 64 個窗口重新精確計算一次總和
+
+int slidingMinMaxInit(SlidingMinMax* state, int windowSize) {
+    if (state == NULL || windowSize <= 0) {
+        return -1;
+    }
+    memset(state, 0, sizeof(*state));
+    state->minValues = malloc(sizeof(double) * (size_t)windowSize);
+    state->minIndices = malloc(sizeof(long long) * (size_t)windowSize);
+    state->maxValues = malloc(sizeof(double) * (size_t)windowSize);
+    state->maxIndices = malloc(sizeof(long long) * (size_t)windowSize);
+    if (state->minValues == NULL || state->minIndices == NULL || state->maxValues == NULL || state->maxIndices == NULL) {
+        slidingMinMaxFree(state);
+        return -1;
+    }
+    state->windowSize = windowSize;
+    return 0;
+}
+
+// 單調佇列：先移除離開窗口的前端，再從後端移除被新樣本支配的元素
+static void dequePush(double* values, long long* indices, int* head, int* count, int capacity,
+                      double input, long long position, int keepSmaller) {
+    while (*count > 0 && indices[*head] <= position - capacity) {
+        *head = *head + 1 == capacity ? 0 : *head + 1;
+        (*count)--;
+    }
+    while (*count > 0) {
+        int back = *head + *count - 1;
+        back -= back >= capacity ? capacity : 0;
+        if (keepSmaller ? values[back] < input : values[back] > input) {
+            break;
+        }
+        (*count)--;
+    }
+    int slot = *head + *count;
+    slot -= slot >= capacity ? capacity : 0;
+    values[slot] = input;
+    indices[slot] = position;
+    (*count)++;
+}
+
+void slidingMinMaxPush(SlidingMinMax* state, double input) {
+    dequePush(state->minValues, state->minIndices, &state->minHead, &state->minCount, state->windowSize,
+              input, state->position, 1);
+    dequePush(state->maxValues, state->maxIndices, &state->maxHead, &state->maxCount, state->windowSize,
+              input, state->position, 0);
+    state->position++;
+}
+
+double slidingMin(const SlidingMinMax* state) {
+    return state->minCount > 0 ? state->minValues[state->minHead] : 0.0;
+}
+
+double slidingMax(const SlidingMinMax* state) {
+    return state->maxCount > 0 ? state->maxValues[state->maxHead] : 0.0;
+}
+
+void slidingMinMaxReset(SlidingMinMax* state) {
+    state->position = 0;
+    state->minHead = 0;
+    state->minCount = 0;
+    state->maxHead = 0;
+    state->maxCount = 0;
+}
+
+void slidingMinMaxFree(SlidingMinMax* state) {
+    if (state == NULL) {
+        return;
+    }
+    free(state->minValues);
+    free(state->minIndices);
+    free(state->maxValues);
+    free(state->maxIndices);
+    memset(state, 0, sizeof(*state));
+}
+
+int slidingVarianceInit(SlidingVariance* state, int windowSize) {
+    if (state == NULL || windowSize <= 0) {
+        return -1;
+    }
+    memset(state, 0, sizeof(*state));
+    state->ring = malloc(sizeof(double) * (size_t)windowSize);
+    if (state->ring == NULL) {
+        return -1;
+    }
+    state->windowSize = windowSize;
+    return 0;
+}
+
+// 以窗口的精確平均值作為新的偏移量
+static void recomputeVariance(SlidingVariance* state) {
+    double sum = 0.0;
+    for (int i = 0; i < state->count; ++i) {
+        sum += state->ring[i] - state->shift;
+    }
+    double shift = state->shift + sum / state->count;
+    double mean = 0.0;
+    double m2 = 0.0;
+    for (int i = 0; i < state->count; ++i) {
+        double deviation = state->ring[i] - shift;
+        mean += deviation;
+        m2 += deviation * deviation;
+    }
+    mean /= state->count;
+    state->shift = shift;
+    state->mean = mean;
+    state->m2 = m2 - mean * mean * state->count;
+    state->sinceExact = 0;
+}
+
+void slidingVariancePush(SlidingVariance* state, double input) {
+    if (state->count == 0) {
+        state->shift = input;
+    }
+    double shifted = input - state->shift;
+    if (state->count < state->windowSize) {
+        // 窗口尚未填滿：標準 Welford 加入
+        state->ring[state->count++] = input;
+        double delta = shifted - state->mean;
+        state->mean += delta / state->count;
+        state->m2 += delta * (shifted - state->mean);
+    } else {
+        // 以新樣本取代最舊的樣本
+        double oldest = state->ring[state->next] - state->shift;
+        state->ring[state->next] = input;
+        state->next = state->next + 1 == state->windowSize ? 0 : state->next + 1;
+        double mean = state->mean + (shifted - oldest) / state->windowSize;
+        state->m2 += (shifted - oldest) * (shifted - mean + oldest - state->mean);
+        state->mean = mean;
+    }
+    if (++state->sinceExact >= (long long)VARIANCE_RECOMPUTE_WINDOWS * state->windowSize) {
+        recomputeVariance(state);
+    }
+}
+
+double slidingVarianceMean(const SlidingVariance* state) {
+    return state->shift + state->mean;
+}
+
+double slidingVarianceValue(const SlidingVariance* state) {
+    if (state->count == 0 || state->m2 <= 0.0) {
+        return 0.0;
+    }
+    return state->m2 / state->count;
+}
+
+void slidingVarianceReset(SlidingVariance* state) {
+    state->next = 0;
+    state->count = 0;
+    state->shift = 0.0;
+    state->mean = 0.0;
+    state->m2 = 0.0;
+    state->sinceExact = 0;
+}
+
+void slidingVarianceFree(SlidingVariance* state) {
+    if (state == NULL) {
+        return;
+    }
+    free(state->ring);
+    memset(state, 0, sizeof(*state));
+}
+
+int slidingMedianInit(SlidingMedian* state, int windowSize) {
+    if (state == NULL || windowSize <= 0) {
+        return -1;
+    }
+    memset(state, 0, sizeof(*state));
+    state->values = malloc(sizeof(double) * (size_t)windowSize);
+    state->lower = malloc(sizeof(int) * (size_t)windowSize);
+    state->upper = malloc(sizeof(int) * (size_t)windowSize);
+    state->location = malloc(sizeof(int) * (size_t)windowSize);
+    if (state->values == NULL || state->lower == NULL || state->upper == NULL || state->location == NULL) {
+        slidingMedianFree(state);
+        return -1;
+    }
+    state->windowSize = windowSize;
+    return 0;
+}
+
+// 堆積以 isLower 區分：下半部為最大堆積，上半部為最小堆積
+static int heapBefore(const SlidingMedian* state, int isLower, int a, int b) {
+    return isLower ? state->values[a] > state->values[b] : state->values[a] < state->values[b];
+}
+
+static void heapPlace(SlidingMedian* state, int isLower, int position, int slot) {
+    (isLower ? state->lower : state->upper)[position] = slot;
+    state->location[slot] = isLower ? position : -(position + 1);
+}
+
+static void heapSiftUp(SlidingMedian* state, int isLower, int position) {
+    int* heap = isLower ? state->lower : state->upper;
+    int slot = heap[position];
+    while (position > 0) {
+        int parent = (position - 1) / 2;
+        if (!heapBefore(state, isLower, slot, heap[parent])) {
+            break;
+        }
+        heapPlace(state, isLower, position, heap[parent]);
+        position = parent;
+    }
+    heapPlace(state, isLower, position, slot);
+}
+
+static void heapSiftDown(SlidingMedian* state, int isLower, int position) {
+    int* heap = isLower ? state->lower : state->upper;
+    int count = isLower ? state->lowerCount : state->upperCount;
+    int slot = heap[position];
+    for (;;) {
+        int child = 2 * position + 1;
+        if (child >= count) {
+            break;
+        }
+        if (child + 1 < count && heapBefore(state, isLower, heap[child + 1], heap[child])) {
+            child++;
+        }
+        if (!heapBefore(state, isLower, heap[child], slot)) {
+            break;
+        }
+        heapPlace(state, isLower, position, heap[child]);
+        position = child;
+    }
+    heapPlace(state, isLower, position, slot);
+}
+
+static void heapInsert(SlidingMedian* state, int isLower, int slot) {
+    int position = isLower ? state->lowerCount++ : state->upperCount++;
+    heapPlace(state, isLower, position, slot);
+    heapSiftUp(state, isLower, position);
+}
+
+static int heapPopTop(SlidingMedian* state, int isLower) {
+    int* heap = isLower ? state->lower : state->upper;
+    int top = heap[0];
+    int last = heap[isLower ? --state->lowerCount : --state->upperCount];
+    if ((isLower ? state->lowerCount : state->upperCount) > 0) {
+        heapPlace(state, isLower, 0, last);
+        heapSiftDown(state, isLower, 0);
+    }
+    return top;
+}
+
+// 依 location 直接移除某個環形位置的樣本
+static void heapRemove(SlidingMedian* state, int slot) {
+    int isLower = state->location[slot] >= 0;
+    int position = isLower ? state->location[slot] : -state->location[slot] - 1;
+    int* heap = isLower ? state->lower : state->upper;
+    int count = isLower ? --state->lowerCount : --state->upperCount;
+    if (position == count) {
+        return;
+    }
+    // 以最後一個元素填洞，再視情況往上或往下調整
+    int moved = heap[count];
+    heapPlace(state, isLower, position, moved);
+    heapSiftUp(state, isLower, position);
+    if (heap[position] == moved) {
+        heapSiftDown(state, isLower, position);
+    }
+}
+
+// 維持 lowerCount == upperCount 或 upperCount + 1
+static void rebalance(SlidingMedian* state) {
+    if (state->lowerCount > state->upperCount + 1) {
+        heapInsert(state, 0, heapPopTop(state, 1));
+    } else if (state->upperCount > state->lowerCount) {
+        heapInsert(state, 1, heapPopTop(state, 0));
+    }
+}
+
+void slidingMedianPush(SlidingMedian* state, double input) {
+    int slot;
+    if (state->count < state->windowSize) {
+        slot = state->count++;
+    } else {
+        slot = state->next;
+        state->next = state->next + 1 == state->windowSize ? 0 : state->next + 1;
+        heapRemove(state, slot);
+    }
+    state->values[slot] = input;
+    int toLower = state->lowerCount == 0 || input <= state->values[state->lower[0]];
+    heapInsert(state, toLower, slot);
+    rebalance(state);
+}
+
+double slidingMedianValue(const SlidingMedian* state) {
+    if (state->lowerCount == 0) {
+        return 0.0;
+    }
+    double lower = state->values[state->lower[0]];
+    if (state->lowerCount > state->upperCount) {
+        return lower;
+    }
+    return 0.5 * (lower + state->values[state->upper[0]]);
+}
+
+void slidingMedianReset(SlidingMedian* state) {
+    state->next = 0;
+    state->count = 0;
+    state->lowerCount = 0;
+    state->upperCount = 0;
+}
+
+void slidingMedianFree(SlidingMedian* state) {
+    if (state == NULL) {
+        return;
+    }
+    free(state->values);
+    free(state->lower);
+    free(state->upper);
+    free(state->location);
+    memset(state, 0, sizeof(*state));
+}
+
+int slidingStatistic(SlidingStatistic statistic, const double* inputData, double* outputData, int dataSize, int windowSize) {
+    if (inputData == NULL || outputData == NULL || dataSize < 0 || windowSize <= 0) {
+        return -1;
+    }
+    switch (statistic) {
+    case SLIDING_MIN:
+    case SLIDING_MAX: {
+        SlidingMinMax state;
+        if (slidingMinMaxInit(&state, windowSize) != 0) {
+            return -1;
+        }
+        for (int i = 0; i < dataSize; ++i) {
+            slidingMinMaxPush(&state, inputData[i]);
+            outputData[i] = statistic == SLIDING_MIN ? slidingMin(&state) : slidingMax(&state);
+        }
+        slidingMinMaxFree(&state);
+        return 0;
+    }
+    case SLIDING_MEAN:
+    case SLIDING_VARIANCE:
+    case SLIDING_STDDEV: {
+        SlidingVariance state;
+        if (slidingVarianceInit(&state, windowSize) != 0) {
+            return -1;
+        }
+        for (int i = 0; i < dataSize; ++i) {
+            slidingVariancePush(&state, inputData[i]);
+            double variance = slidingVarianceValue(&state);
+            outputData[i] = statistic == SLIDING_MEAN ? slidingVarianceMean(&state)
+                : statistic == SLIDING_VARIANCE ? variance : sqrt(variance);
+        }
+        slidingVarianceFree(&state);
+        return 0;
+    }
+    case SLIDING_MEDIAN: {
+        SlidingMedian state;
+        if (slidingMedianInit(&state, windowSize) != 0) {
+            return -1;
+        }
+        for (int i = 0; i < dataSize; ++i) {
+            slidingMedianPush(&state, inputData[i]);
+            outputData[i] = slidingMedianValue(&state);
+        }
+        slidingMedianFree(&state);
+        return 0;
+    }
+    }
+    return -1;
+}
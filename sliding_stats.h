@@ -0,0 +1,118 @@
+// sliding_stats.h
+
+#ifndef SLIDING_STATS_H
+#define SLIDING_STATS_H
+
+/*
+ * Sliding-window statistics over the last windowSize samples, in O(1) or O(log w) per
+ * sample instead of recomputing every window (O(w) per sample).
+ *
+ *   SlidingMinMax     monotonic deques: each sample enters and leaves each deque once,
+ *                     so min and max cost amortized O(1).
+ *   SlidingVariance   Welford-style running mean and sum of squared deviations, updated
+ *                     by swapping the oldest sample for the newest in O(1). Samples are
+ *                     taken relative to a recent mean (a large gravity offset does not
+ *                     eat the precision) and the sums are recomputed exactly from the
+ *                     window every 64 windows, so rounding error does not accumulate on
+ *                     long recordings.
+ *   SlidingMedian     two heaps (a max-heap of the lower half, a min-heap of the upper
+ *                     half) indexed by ring position, so the outgoing sample is removed
+ *                     directly in O(log w).
+ *
+ * Every state follows the lifecycle of stream_filters.h: xxxInit() once, xxxPush() per
+ * sample (the statistics then describe the window ending at that sample), xxxReset() to
+ * start a new recording and xxxFree() when done. As with calculateMovingAverage(), the
+ * first windowSize - 1 windows contain only the samples seen so far. slidingStatistic()
+ * runs any of them over a whole array.
+ */
+
+/**
+ * Statistics computed by slidingStatistic().
+ */
+typedef enum {
+    SLIDING_MIN,
+    SLIDING_MAX,
+    SLIDING_MEAN,
+    SLIDING_VARIANCE,     // population variance of the window (divides by the sample count)
+    SLIDING_STDDEV,
+    SLIDING_MEDIAN        // mean of the two middle samples for an even count
+} SlidingStatistic;
+
+typedef struct {
+    int windowSize;
+    long long position;   // samples pushed so far
+    // 遞增（最小值）與遞減（最大值）的單調佇列，環形存放
+    double* minValues;
+    long long* minIndices;
+    int minHead;
+    int minCount;
+    double* maxValues;
+    long long* maxIndices;
+    int maxHead;
+    int maxCount;
+} SlidingMinMax;
+
+typedef struct {
+    int windowSize;
+    double* ring;         // last windowSize samples
+    int next;             // slot of the oldest sample once the ring is full
+    int count;            // samples in the window
+    double shift;         // offset subtracted from every sample
+    double mean;          // mean of the shifted samples
+    double m2;            // sum of squared deviations from mean
+    long long sinceExact; // pushes since the sums were last recomputed
+} SlidingVariance;
+
+typedef struct {
+    int windowSize;
+    double* values;       // ring of the last windowSize samples
+    int next;
+    int count;
+    int* lower;           // max-heap of ring slots (lower half)
+    int lowerCount;
+    int* upper;           // min-heap of ring slots (upper half)
+    int upperCount;
+    int* location;        // heap position of each slot: >= 0 in lower, < 0 at -(position + 1) in upper
+} SlidingMedian;
+
+/**
+ * @return 0 on success, -1 if windowSize is non-positive or allocation fails.
+ */
+int slidingMinMaxInit(SlidingMinMax* state, int windowSize);
+void slidingMinMaxPush(SlidingMinMax* state, double input);
+double slidingMin(const SlidingMinMax* state);
+double slidingMax(const SlidingMinMax* state);
+void slidingMinMaxReset(SlidingMinMax* state);
+void slidingMinMaxFree(SlidingMinMax* state);
+
+/**
+ * @return 0 on success, -1 if windowSize is non-positive or allocation fails.
+ */
+int slidingVarianceInit(SlidingVariance* state, int windowSize);
+void slidingVariancePush(SlidingVariance* state, double input);
+double slidingVarianceMean(const SlidingVariance* state);
+double slidingVarianceValue(const SlidingVariance* state);
+void slidingVarianceReset(SlidingVariance* state);
+void slidingVarianceFree(SlidingVariance* state);
+
+/**
+ * @return 0 on success, -1 if windowSize is non-positive or allocation fails.
+ */
+int slidingMedianInit(SlidingMedian* state, int windowSize);
+void slidingMedianPush(SlidingMedian* state, double input);
+double slidingMedianValue(const SlidingMedian* state);
+void slidingMedianReset(SlidingMedian* state);
+void slidingMedianFree(SlidingMedian* state);
+
+/**
+ * Computes a sliding statistic over a whole array: outputData[i] describes the window of
+ * windowSize samples ending at inputData[i] (fewer at the start).
+ *
+ * @return 0 on success, -1 on invalid arguments or allocation failure.
+ *
+ * Example usage (rolling variance of the acceleration magnitude over 0.5 s at 100 Hz):
+ *     slidingStatistic(SLIDING_VARIANCE, magnitude, variance, dataSize, 50);
+ */
+int slidingStatistic(SlidingStatistic statistic, const double* inputData, double* outputData, int dataSize, int windowSize);
+
+#endif // SLIDING_STATS_H
@@ -0,0 +1,113 @@
+// spsc_ring.c
+#include <stdlib.h>
+#include <string.h>
+
+#include "spsc_ring.h"
+
+int spscRingInit(SpscRing* ring, size_t elementSize, size_t capacity) {
+    if (ring == NULL || elementSize == 0 || capacity == 0 || capacity > ((size_t)1 << 40)) {
+        return -1;
+    }
+    size_t rounded = 1;
+    while (rounded < capacity) {
+        rounded <<= 1;
+    }
+    memset(ring, 0, sizeof(*ring));
+    ring->slots = malloc(elementSize * rounded);
+    if (ring->slots == NULL) {
+        return -1;
+    }
+    ring->elementSize = elementSize;
+    ring->mask = rounded - 1;
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+    atomic_init(&ring->closed, 0);
+    return 0;
+}
+
+void spscRingFree(SpscRing* ring) {
+    if (ring == NULL) {
+        return;
+    }
+    free(ring->slots);
+    ring->slots = NULL;
+}
+
+// 以環形位置複製，必要時分成兩段
+static void copyIn(SpscRing* ring, size_t position, const unsigned char* source, size_t count) {
+    size_t capacity = ring->mask + 1;
+    size_t first = capacity - (position & ring->mask);
+    if (first > count) {
+        first = count;
+    }
+    memcpy(ring->slots + (position & ring->mask) * ring->elementSize, source, first * ring->elementSize);
+    memcpy(ring->slots, source + first * ring->elementSize, (count - first) * ring->elementSize);
+}
+
+static void copyOut(SpscRing* ring, size_t position, unsigned char* destination, size_t count) {
+    size_t capacity = ring->mask + 1;
+    size_t first = capacity - (position & ring->mask);
+    if (first > count) {
+        first = count;
+    }
+    memcpy(destination, ring->slots + (position & ring->mask) * ring->elementSize, first * ring->elementSize);
+    memcpy(destination + first * ring->elementSize, ring->slots, (count - first) * ring->elementSize);
+}
+
+size_t spscRingPush(SpscRing* ring, const void* elements, size_t count) {
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    size_t capacity = ring->mask + 1;
+    size_t space = capacity - (tail - ring->cachedHead);
+    if (space < count) {
+        // 只有快取的 head 不夠用時才讀取共享的 head
+        ring->cachedHead = atomic_load_explicit(&ring->head, memory_order_acquire);
+        space = capacity - (tail - ring->cachedHead);
+    }
+    if (count > space) {
+        count = space;
+    }
+    if (count == 0) {
+        return 0;
+    }
+    copyIn(ring, tail, elements, count);
+    atomic_store_explicit(&ring->tail, tail + count, memory_order_release);
+    return count;
+}
+
+size_t spscRingPop(SpscRing* ring, void* elements, size_t maxCount) {
+    size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    size_t available = ring->cachedTail - head;
+    if (available < maxCount) {
+        ring->cachedTail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+        available = ring->cachedTail - head;
+    }
+    if (maxCount > available) {
+        maxCount = available;
+    }
+    if (maxCount == 0) {
+        return 0;
+    }
+    copyOut(ring, head, elements, maxCount);
+    atomic_store_explicit(&ring->head, head + maxCount, memory_order_release);
+    return maxCount;
+}
+
+void spscRingClose(SpscRing* ring) {
+    atomic_store_explicit(&ring->closed, 1, memory_order_release);
+}
+
+int spscRingDrained(SpscRing* ring) {
+    // 先讀 closed 再讀 tail：關閉前推入的元素一定看得到
+    if (!atomic_load_explicit(&ring->closed, memory_order_acquire)) {
+        return 0;
+    }
+    return atomic_load_explicit(&ring->tail, memory_order_acquire) == atomic_load_explicit(&ring->head, memory_order_relaxed);
+}
+
+size_t spscRingSize(SpscRing* ring) {
+    return atomic_load_explicit(&ring->tail, memory_order_acquire) - atomic_load_explicit(&ring->head, memory_order_acquire);
+}
+
+size_t spscRingCapacity(const SpscRing* ring) {
+    return ring->mask + 1;
+}
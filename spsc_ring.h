@@ -0,0 +1,82 @@
+// spsc_ring.h
+
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <stddef.h>
+#include <stdatomic.h>
+
+/*
+ * Lock-free single-producer / single-consumer ring buffer of fixed-size elements.
+ *
+ * Exactly one thread may push and exactly one (other) thread may pop. The producer owns
+ * tail and the consumer owns head; each publishes its index with a release store and
+ * reads the other's with an acquire load, so no locks or read-modify-write atomics are
+ * needed. The indices live on separate cache lines, and each side caches the last value
+ * it saw of the other's index so a transfer of many elements touches the shared line
+ * once. Transfers are in bulk: a push or pop moves as many elements as fit in one call.
+ *
+ * The capacity is fixed at creation, so a stalled consumer makes the producer wait
+ * instead of growing memory.
+ */
+
+#define SPSC_CACHE_LINE 64
+
+typedef struct {
+    // 生產者寫入的欄位
+    _Alignas(SPSC_CACHE_LINE) atomic_size_t tail;   // next slot to write
+    size_t cachedHead;                              // producer's last view of head
+    // 消費者寫入的欄位
+    _Alignas(SPSC_CACHE_LINE) atomic_size_t head;   // next slot to read
+    size_t cachedTail;                              // consumer's last view of tail
+    // 建立後不變
+    _Alignas(SPSC_CACHE_LINE) unsigned char* slots;
+    size_t elementSize;
+    size_t mask;                                    // capacity - 1
+    atomic_int closed;                              // set by the producer at end of stream
+} SpscRing;
+
+/**
+ * Initializes a ring holding capacity elements of elementSize bytes.
+ *
+ * @param capacity Rounded up to a power of two.
+ * @return 0 on success, -1 on invalid arguments or allocation failure.
+ */
+int spscRingInit(SpscRing* ring, size_t elementSize, size_t capacity);
+
+void spscRingFree(SpscRing* ring);
+
+/**
+ * Producer: copies up to count elements into the ring.
+ *
+ * @return The number of elements pushed (0 if the ring is full).
+ */
+size_t spscRingPush(SpscRing* ring, const void* elements, size_t count);
+
+/**
+ * Consumer: copies up to maxCount of the oldest elements out of the ring.
+ *
+ * @return The number of elements popped (0 if the ring is empty).
+ */
+size_t spscRingPop(SpscRing* ring, void* elements, size_t maxCount);
+
+/**
+ * Producer: marks the end of the stream. Elements already pushed can still be popped.
+ */
+void spscRingClose(SpscRing* ring);
+
+/**
+ * Consumer: returns 1 once the producer has closed the ring and every element has been
+ * popped.
+ */
+int spscRingDrained(SpscRing* ring);
+
+/**
+ * Number of elements currently stored (exact only when called by one of the two sides
+ * while the other is idle).
+ */
+size_t spscRingSize(SpscRing* ring);
+
+size_t spscRingCapacity(const SpscRing* ring);
+
+#endif // SPSC_RING_H
@@ -0,0 +1,207 @@
+// stream_filters.c
+#include <stdlib.h>
+#include <string.h>
+
+#include "stream_filters.h"
+#include "dsp_kernels.h"
+
+int movingAverageInit(MovingAverageState* state, int windowSize) {
+    if (state == NULL || windowSize <= 0) {
+        return -1;
+    }
+    memset(state, 0, sizeof(*state));
+    state->ring = malloc(sizeof(double) * (size_t)windowSize);
+    if (state->ring == NULL) {
+        return -1;
+    }
+    state->windowSize = windowSize;
+    state->ownsRing = 1;
+    return 0;
+}
+
+int movingAverageInitBuffer(MovingAverageState* state, int windowSize, double* ring) {
+    if (state == NULL || windowSize <= 0 || ring == NULL) {
+        return -1;
+    }
+    memset(state, 0, sizeof(*state));
+    state->ring = ring;
+    state->windowSize = windowSize;
+    return 0;
+}
+
+double movingAveragePush(MovingAverageState* state, double input) {
+    // 與 calculateMovingAverage 相同的運算順序：先加入新樣本，再移除最舊的樣本
+    neumaierAdd(&state->sum, &state->compensation, input);
+    int ramp = state->filled < state->windowSize;
+    int count;
+    if (!ramp) {
+        neumaierAdd(&state->sum, &state->compensation, -state->ring[state->position]);
+        count = state->windowSize;
+    } else {
+        count = ++state->filled;
+    }
+    state->ring[state->position] = input;
+    if (++state->position == state->windowSize) {
+        state->position = 0;
+    }
+    if (ramp) {
+        // 填滿前環形緩衝區依序存放 0..count-1，與批次版本相同的求和順序
+        return rampAverage(state->ring, count);
+    }
+    return (state->sum + state->compensation) / count;
+}
+
+void movingAveragePushBlock(MovingAverageState* state, const double* inputData, double* outputData, int dataSize) {
+    if (state == NULL || inputData == NULL || outputData == NULL) {
+        return;
+    }
+    for (int i = 0; i < dataSize; ++i) {
+        outputData[i] = movingAveragePush(state, inputData[i]);
+    }
+}
+
+void movingAverageReset(MovingAverageState* state) {
+    state->position = 0;
+    state->filled = 0;
+    state->sum = 0.0;
+    state->compensation = 0.0;
+}
+
+void movingAverageFree(MovingAverageState* state) {
+    if (state == NULL) {
+        return;
+    }
+    if (state->ownsRing) {
+        free(state->ring);
+    }
+    state->ring = NULL;
+    state->ownsRing = 0;
+    state->windowSize = 0;
+}
+
+void lowPassInit(LowPassState* state, double alpha) {
+    state->alpha = alpha;
+    state->value = 0.0;
+    state->primed = 0;
+}
+
+int lowPassInitButterworth(LowPassState* state, double cutoffFrequency, double samplingRate) {
+    if (state == NULL || cutoffFrequency <= 0 || samplingRate <= 0) {
+        return -1;
+    }
+    lowPassInit(state, butterworthAlpha(cutoffFrequency, samplingRate));
+    return 0;
+}
+
+double lowPassPush(LowPassState* state, double input) {
+    if (!state->primed) {
+        state->value = input; // 第一個樣本直接輸出，與批次版本相同
+        state->primed = 1;
+    } else {
+        state->value = lowPassStep(state->alpha, input, state->value);
+    }
+    return state->value;
+}
+
+void lowPassPushBlock(LowPassState* state, const double* inputData, double* outputData, int dataSize) {
+    if (state == NULL || inputData == NULL || outputData == NULL) {
+        return;
+    }
+    for (int i = 0; i < dataSize; ++i) {
+        outputData[i] = lowPassPush(state, inputData[i]);
+    }
+}
+
+void lowPassReset(LowPassState* state) {
+    state->value = 0.0;
+    state->primed = 0;
+}
+
+int movementDetectorInit(MovementDetectorState* state, double threshold, double samplingRate) {
+    if (state == NULL || samplingRate <= 0) {
+        return -1;
+    }
+    double dt = 1.0 / samplingRate;
+    state->threshold = threshold;
+    state->dtSquared = dt * dt;
+    movementDetectorReset(state);
+    return 0;
+}
+
+int movementDetectorPush(MovementDetectorState* state, double input, double* output) {
+    long long index = state->count++;
+    int written = 0;
+    if (index == 1) {
+        *output = movementEdge(state->threshold); // 第一個樣本無法計算二階微分
+        written = 1;
+    } else if (index >= 2) {
+        *output = movementStep(state->previous, state->current, input, state->dtSquared, state->threshold);
+        written = 1;
+    }
+    state->previous = state->current;
+    state->current = input;
+    return written;
+}
+
+int movementDetectorPushBlock(MovementDetectorState* state, const double* inputData, double* outputData, int dataSize) {
+    if (state == NULL || inputData == NULL || outputData == NULL) {
+        return 0;
+    }
+    int written = 0;
+    for (int i = 0; i < dataSize; ++i) {
+        written += movementDetectorPush(state, inputData[i], &outputData[written]);
+    }
+    return written;
+}
+
+int movementDetectorFlush(MovementDetectorState* state, double* output) {
+    if (state->count == 0) {
+        return 0;
+    }
+    *output = movementEdge(state->threshold); // 最後一個樣本同樣無法計算二階微分
+    movementDetectorReset(state);
+    return 1;
+}
+
+void movementDetectorReset(MovementDetectorState* state) {
+    state->previous = 0.0;
+    state->current = 0.0;
+    state->count = 0;
+}
+
+void zuptInit(ZuptState* state, double threshold, int continuousCountThreshold) {
+    state->threshold = threshold;
+    state->continuousCountThreshold = continuousCountThreshold;
+    zuptReset(state);
+}
+
+int zuptPush(ZuptState* state, double* velocity, double accel) {
+    if (state->detected) {
+        return 1; // 與 applyZupt 相同：偵測到後即停止處理
+    }
+    if (fabs(accel) < state->threshold) {
+        state->continuousCount++;
+        *velocity = 0.0;
+        if (state->continuousCount >= state->continuousCountThreshold) {
+            state->detected = 1;
+        }
+    } else {
+        state->continuousCount = 0;
+    }
+    return state->detected;
+}
+
+int zuptPushBlock(ZuptState* state, double* velocityData, const double* accelData, int dataSize) {
+    if (state == NULL || velocityData == NULL || accelData == NULL) {
+        return -1;
+    }
+    for (int i = 0; i < dataSize && !state->detected; ++i) {
+        zuptPush(state, &velocityData[i], accelData[i]);
+    }
+    return state->detected;
+}
+
+void zuptReset(ZuptState* state) {
+    state->continuousCount = 0;
+    state->detected = 0;
+}
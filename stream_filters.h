@@ -0,0 +1,182 @@
+// stream_filters.h
+
+#ifndef STREAM_FILTERS_H
+#define STREAM_FILTERS_H
+
+/*
+ * Stateful, sample-by-sample versions of the batch functions in data_processing.h.
+ *
+ * Each filter keeps only the state it needs between calls (a ring buffer of windowSize
+ * samples for the moving average, one value for the low-pass filters, two samples for
+ * movement detection and a counter for ZUPT), so memory stays bounded no matter how
+ * long the stream runs. Feeding the same data in blocks of any size produces output
+ * that is bit-identical to the corresponding batch function, with one exception: for
+ * streams shorter than three samples detectMovement() writes nothing, whereas the
+ * streaming detector reports every sample as an edge (see MovementDetectorState).
+ *
+ * Typical lifecycle: xxxInit() once, xxxPush()/xxxPushBlock() for every sample or
+ * block, xxxReset() to start a new recording, xxxFree() when done (moving average only).
+ */
+
+/**
+ * State of a streaming moving average, see calculateMovingAverage().
+ */
+typedef struct {
+    double* ring;        // last windowSize input samples
+    int windowSize;
+    int position;        // next slot to overwrite in ring
+    int filled;          // number of valid samples in ring
+    double sum;
+    double compensation;
+    int ownsRing;        // ring was allocated by movingAverageInit()
+} MovingAverageState;
+
+/**
+ * Initializes a moving average over windowSize samples.
+ *
+ * @return 0 on success, -1 if windowSize is non-positive or allocation fails.
+ */
+int movingAverageInit(MovingAverageState* state, int windowSize);
+
+/**
+ * Like movingAverageInit(), but uses ring (windowSize doubles, owned by the caller, e.g.
+ * from a DspContext) instead of allocating; movingAverageFree() leaves it alone.
+ *
+ * @return 0 on success, -1 if windowSize is non-positive or ring is NULL.
+ */
+int movingAverageInitBuffer(MovingAverageState* state, int windowSize, double* ring);
+
+/**
+ * Pushes one sample and returns the moving average including it. The first
+ * windowSize - 1 outputs average over the samples seen so far, as in the batch version.
+ */
+double movingAveragePush(MovingAverageState* state, double input);
+
+/**
+ * Pushes dataSize samples; outputData receives one average per input sample.
+ * inputData and outputData may be the same array.
+ */
+void movingAveragePushBlock(MovingAverageState* state, const double* inputData, double* outputData, int dataSize);
+
+/**
+ * Forgets all history so the next sample starts a new ramp-up.
+ */
+void movingAverageReset(MovingAverageState* state);
+
+/**
+ * Releases the ring buffer if movingAverageInit() allocated it.
+ */
+void movingAverageFree(MovingAverageState* state);
+
+/**
+ * State of a first-order exponential low-pass filter, see butterworthLowPassFilter()
+ * and applyLowPassFilter(). The first sample pushed passes through unchanged.
+ */
+typedef struct {
+    double alpha;
+    double value;
+    int primed;
+} LowPassState;
+
+/**
+ * Initializes a low-pass filter with an explicit smoothing factor. Use
+ * APPLY_LOW_PASS_ALPHA to match applyLowPassFilter().
+ */
+void lowPassInit(LowPassState* state, double alpha);
+
+/**
+ * Initializes a low-pass filter matching butterworthLowPassFilter().
+ *
+ * @return 0 on success, -1 if cutoffFrequency or samplingRate is non-positive.
+ */
+int lowPassInitButterworth(LowPassState* state, double cutoffFrequency, double samplingRate);
+
+double lowPassPush(LowPassState* state, double input);
+
+/**
+ * Filters dataSize samples. inputData and outputData may be the same array.
+ */
+void lowPassPushBlock(LowPassState* state, const double* inputData, double* outputData, int dataSize);
+
+void lowPassReset(LowPassState* state);
+
+/**
+ * State of streaming movement detection, see detectMovement().
+ *
+ * The second derivative at sample i needs sample i + 1, so results are delayed by one
+ * sample: pushing sample i produces the result for sample i - 1, and
+ * movementDetectorFlush() produces the result for the last sample, which like the first
+ * one has no second derivative and is reported as 0.0 for any non-negative threshold.
+ * A stream of one or two samples therefore yields one or two edge results, while
+ * detectMovement() leaves outputData untouched for dataSize < 3; from three samples on
+ * the results match detectMovement() exactly.
+ */
+typedef struct {
+    double threshold;
+    double dtSquared;
+    double previous;     // sample i - 2
+    double current;      // sample i - 1
+    long long count;     // samples pushed so far
+} MovementDetectorState;
+
+/**
+ * @return 0 on success, -1 if samplingRate is non-positive.
+ */
+int movementDetectorInit(MovementDetectorState* state, double threshold, double samplingRate);
+
+/**
+ * Pushes one sample.
+ *
+ * @param output Receives the result for the previous sample (1.0 movement, 0.0 none).
+ * @return 1 if *output was written, 0 for the very first sample.
+ */
+int movementDetectorPush(MovementDetectorState* state, double input, double* output);
+
+/**
+ * Pushes dataSize samples and writes the available results to outputData.
+ *
+ * @return The number of results written: dataSize, or dataSize - 1 for the first block.
+ */
+int movementDetectorPushBlock(MovementDetectorState* state, const double* inputData, double* outputData, int dataSize);
+
+/**
+ * Emits the result for the last pushed sample.
+ *
+ * @return 1 if *output was written, 0 if nothing has been pushed.
+ */
+int movementDetectorFlush(MovementDetectorState* state, double* output);
+
+void movementDetectorReset(MovementDetectorState* state);
+
+/**
+ * State of streaming Zero Velocity Update detection, see applyZupt().
+ *
+ * Like the batch function, detection latches: once continuousCountThreshold consecutive
+ * samples are below the threshold, further pushes leave the velocity untouched until
+ * zuptReset() is called.
+ */
+typedef struct {
+    double threshold;
+    int continuousCountThreshold;
+    int continuousCount;
+    int detected;
+} ZuptState;
+
+void zuptInit(ZuptState* state, double threshold, int continuousCountThreshold);
+
+/**
+ * Pushes one acceleration sample; *velocity is set to zero while below the threshold.
+ *
+ * @return 1 if zero velocity has been detected, 0 otherwise.
+ */
+int zuptPush(ZuptState* state, double* velocity, double accel);
+
+/**
+ * Pushes dataSize samples; same return value as applyZupt() for the data seen so far
+ * (-1 for null pointers).
+ */
+int zuptPushBlock(ZuptState* state, double* velocityData, const double* accelData, int dataSize);
+
+void zuptReset(ZuptState* state);
+
+#endif // STREAM_FILTERS_H
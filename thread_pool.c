@@ -0,0 +1,249 @@
+// thread_pool.c
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "thread_pool.h"
+
+typedef struct {
+    ThreadPoolTask task;
+    void* argument;
+} TaskEntry;
+
+// 每個工作執行緒自己的雙端佇列（環形緩衝區）
+typedef struct {
+    pthread_mutex_t lock;
+    TaskEntry* entries;
+    int capacity;
+    int head;     // 最舊的任務（被偷取端）
+    int count;
+} TaskDeque;
+
+typedef struct {
+    ThreadPool* pool;
+    int index;
+} WorkerStart;
+
+struct ThreadPool {
+    int threadCount;
+    int startedCount;
+    pthread_t* threads;
+    WorkerStart* starts;
+    TaskDeque* deques;
+    atomic_int queued;          // 已提交、尚未被取走的任務數
+    atomic_int pending;         // 已提交、尚未完成的任務數
+    atomic_uint nextDeque;      // 外部提交的輪替位置
+    int stopping;
+    pthread_mutex_t lock;
+    pthread_cond_t workAvailable;
+    pthread_cond_t allDone;
+};
+
+static _Thread_local ThreadPool* currentPool = NULL;
+static _Thread_local int currentWorker = -1;
+
+static int dequePushBack(TaskDeque* deque, TaskEntry entry) {
+    pthread_mutex_lock(&deque->lock);
+    if (deque->count == deque->capacity) {
+        int newCapacity = deque->capacity > 0 ? deque->capacity * 2 : 64;
+        TaskEntry* grown = malloc(sizeof(TaskEntry) * (size_t)newCapacity);
+        if (grown == NULL) {
+            pthread_mutex_unlock(&deque->lock);
+            return -1;
+        }
+        for (int i = 0; i < deque->count; ++i) {
+            grown[i] = deque->entries[(deque->head + i) % deque->capacity];
+        }
+        free(deque->entries);
+        deque->entries = grown;
+        deque->capacity = newCapacity;
+        deque->head = 0;
+    }
+    deque->entries[(deque->head + deque->count) % deque->capacity] = entry;
+    deque->count++;
+    pthread_mutex_unlock(&deque->lock);
+    return 0;
+}
+
+// 擁有者從尾端取出最新的任務
+static int dequePopBack(TaskDeque* deque, TaskEntry* entry) {
+    pthread_mutex_lock(&deque->lock);
+    int found = deque->count > 0;
+    if (found) {
+        deque->count--;
+        *entry = deque->entries[(deque->head + deque->count) % deque->capacity];
+    }
+    pthread_mutex_unlock(&deque->lock);
+    return found;
+}
+
+// 其他執行緒從前端偷取最舊的任務
+static int dequeStealFront(TaskDeque* deque, TaskEntry* entry) {
+    pthread_mutex_lock(&deque->lock);
+    int found = deque->count > 0;
+    if (found) {
+        *entry = deque->entries[deque->head];
+        deque->head = (deque->head + 1) % deque->capacity;
+        deque->count--;
+    }
+    pthread_mutex_unlock(&deque->lock);
+    return found;
+}
+
+static int takeTask(ThreadPool* pool, int self, TaskEntry* entry) {
+    if (dequePopBack(&pool->deques[self], entry)) {
+        return 1;
+    }
+    for (int offset = 1; offset < pool->threadCount; ++offset) {
+        if (dequeStealFront(&pool->deques[(self + offset) % pool->threadCount], entry)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void* workerMain(void* argument) {
+    WorkerStart* start = argument;
+    ThreadPool* pool = start->pool;
+    int self = start->index;
+    currentPool = pool;
+    currentWorker = self;
+
+    for (;;) {
+        TaskEntry entry;
+        if (takeTask(pool, self, &entry)) {
+            atomic_fetch_sub(&pool->queued, 1);
+            entry.task(entry.argument, self);
+            if (atomic_fetch_sub(&pool->pending, 1) == 1) {
+                pthread_mutex_lock(&pool->lock);
+                pthread_cond_broadcast(&pool->allDone);
+                pthread_mutex_unlock(&pool->lock);
+            }
+            continue;
+        }
+
+        pthread_mutex_lock(&pool->lock);
+        while (atomic_load(&pool->queued) == 0 && !pool->stopping) {
+            pthread_cond_wait(&pool->workAvailable, &pool->lock);
+        }
+        int stop = pool->stopping && atomic_load(&pool->queued) == 0;
+        pthread_mutex_unlock(&pool->lock);
+        if (stop) {
+            break;
+        }
+    }
+    return NULL;
+}
+
+ThreadPool* threadPoolCreate(int threadCount) {
+    if (threadCount <= 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threadCount = online > 0 ? (int)online : 1;
+    }
+
+    ThreadPool* pool = calloc(1, sizeof(ThreadPool));
+    if (pool == NULL) {
+        return NULL;
+    }
+    pool->threads = calloc((size_t)threadCount, sizeof(pthread_t));
+    pool->starts = calloc((size_t)threadCount, sizeof(WorkerStart));
+    pool->deques = calloc((size_t)threadCount, sizeof(TaskDeque));
+    if (pool->threads == NULL || pool->starts == NULL || pool->deques == NULL) {
+        free(pool->threads);
+        free(pool->starts);
+        free(pool->deques);
+        free(pool);
+        return NULL;
+    }
+    atomic_init(&pool->queued, 0);
+    atomic_init(&pool->pending, 0);
+    atomic_init(&pool->nextDeque, 0);
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->workAvailable, NULL);
+    pthread_cond_init(&pool->allDone, NULL);
+    for (int i = 0; i < threadCount; ++i) {
+        pthread_mutex_init(&pool->deques[i].lock, NULL);
+    }
+
+    pool->threadCount = threadCount;
+    for (int i = 0; i < threadCount; ++i) {
+        pool->starts[i].pool = pool;
+        pool->starts[i].index = i;
+        if (pthread_create(&pool->threads[i], NULL, workerMain, &pool->starts[i]) != 0) {
+            threadPoolDestroy(pool); // 只回收已啟動的執行緒
+            return NULL;
+        }
+        pool->startedCount++;
+    }
+    return pool;
+}
+
+int threadPoolSubmit(ThreadPool* pool, ThreadPoolTask task, void* argument) {
+    if (pool == NULL || task == NULL) {
+        return -1;
+    }
+
+    int target;
+    if (currentPool == pool) {
+        target = currentWorker;
+    } else {
+        target = (int)(atomic_fetch_add(&pool->nextDeque, 1) % (unsigned)pool->threadCount);
+    }
+
+    TaskEntry entry = {task, argument};
+    atomic_fetch_add(&pool->pending, 1);
+    if (dequePushBack(&pool->deques[target], entry) != 0) {
+        atomic_fetch_sub(&pool->pending, 1);
+        return -1;
+    }
+    atomic_fetch_add(&pool->queued, 1);
+
+    pthread_mutex_lock(&pool->lock);
+    pthread_cond_signal(&pool->workAvailable);
+    pthread_mutex_unlock(&pool->lock);
+    return 0;
+}
+
+void threadPoolWait(ThreadPool* pool) {
+    if (pool == NULL) {
+        return;
+    }
+    pthread_mutex_lock(&pool->lock);
+    while (atomic_load(&pool->pending) > 0) {
+        pthread_cond_wait(&pool->allDone, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
+
+int threadPoolSize(const ThreadPool* pool) {
+    return pool != NULL ? pool->threadCount : 0;
+}
+
+void threadPoolDestroy(ThreadPool* pool) {
+    if (pool == NULL) {
+        return;
+    }
+    threadPoolWait(pool);
+
+    pthread_mutex_lock(&pool->lock);
+    pool->stopping = 1;
+    pthread_cond_broadcast(&pool->workAvailable);
+    pthread_mutex_unlock(&pool->lock);
+    for (int i = 0; i < pool->startedCount; ++i) {
+        pthread_join(pool->threads[i], NULL);
+    }
+
+    for (int i = 0; i < pool->threadCount; ++i) {
+        pthread_mutex_destroy(&pool->deques[i].lock);
+        free(pool->deques[i].entries);
+    }
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->workAvailable);
+    pthread_cond_destroy(&pool->allDone);
+    free(pool->threads);
+    free(pool->starts);
+    free(pool->deques);
+    free(pool);
+}
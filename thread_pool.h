@@ -0,0 +1,52 @@
+// thread_pool.h
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+/**
+ * A task run by the pool. workerIndex is in [0, threadPoolSize()) and identifies the
+ * worker executing the task, so callers can keep per-worker scratch buffers indexed by it
+ * without any locking.
+ */
+typedef void (*ThreadPoolTask)(void* argument, int workerIndex);
+
+typedef struct ThreadPool ThreadPool;
+
+/**
+ * Creates a work-stealing thread pool.
+ *
+ * Every worker owns a deque of tasks. A worker pops its own newest task first (LIFO,
+ * good cache locality for tasks it spawned itself) and, when its deque is empty, steals
+ * the oldest task from another worker (FIFO, large chunks of work). Tasks submitted from
+ * inside a task go to the submitting worker's own deque; tasks submitted from outside the
+ * pool are distributed round-robin.
+ *
+ * @param threadCount Number of worker threads; 0 or negative uses the number of online CPUs.
+ * @return The pool, or NULL if threads or memory could not be allocated.
+ */
+ThreadPool* threadPoolCreate(int threadCount);
+
+/**
+ * Queues a task. Safe to call from any thread, including from inside a running task.
+ *
+ * @return 0 on success, -1 on allocation failure.
+ */
+int threadPoolSubmit(ThreadPool* pool, ThreadPoolTask task, void* argument);
+
+/**
+ * Blocks until every submitted task, including tasks submitted by other tasks, has
+ * finished. Must not be called from inside a task.
+ */
+void threadPoolWait(ThreadPool* pool);
+
+/**
+ * @return The number of worker threads.
+ */
+int threadPoolSize(const ThreadPool* pool);
+
+/**
+ * Waits for outstanding tasks, stops the workers and frees the pool.
+ */
+void threadPoolDestroy(ThreadPool* pool);
+
+#endif // THREAD_POOL_H